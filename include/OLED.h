@@ -2,67 +2,185 @@
 #define OLED_H
 
 #include <Arduino.h>
-#include <Wire.h>
-
-// Pin definitions for Heltec ESP32 LoRa v3
-#define VEXT_PIN 36
-#define SDA_PIN 17
-#define SCL_PIN 18
-#define RST_PIN 21
-#define I2C_ADDR 0x3C
-
-// Display dimensions
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-#define BUFFER_SIZE (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
-
-// SSD1306 Commands
-#define SSD1306_DISPLAYOFF                  0xAE
-#define SSD1306_SETDISPLAYCLOCKDIV          0xD5
-#define SSD1306_SETMULTIPLEX                0xA8
-#define SSD1306_SETDISPLAYOFFSET            0xD3
-#define SSD1306_SETSTARTLINE                0x40
-#define SSD1306_CHARGEPUMP                  0x8D
-#define SSD1306_MEMORYMODE                  0x20
-#define SSD1306_SEGREMAP                    0xA0
-#define SSD1306_COMSCANDEC                  0xC8
-#define SSD1306_SETCOMPINS                  0xDA
-#define SSD1306_SETCONTRAST                 0x81
-#define SSD1306_SETPRECHARGE                0xD9
-#define SSD1306_SETVCOMDETECT               0xDB
-#define SSD1306_DISPLAYALLON_RESUME         0xA4
-#define SSD1306_NORMALDISPLAY               0xA6
-#define SSD1306_DISPLAYON                   0xAF
-#define SSD1306_COLUMNADDR                  0x21
-#define SSD1306_PAGEADDR                    0x22
-
-class OLED {
+#include <atomic>
+#include "fonts.h"
+#include "icons.h"
+#include "fb_kernels.h"
+#include "oled_backend.h"
+
+// Data bytes streamed per flushStep() call when no budget is given
+#define OLED_FLUSH_STEP_BYTES 128
+
+class ScreenMirror;
+
+// How drawBitmap() combines bitmap bits with the framebuffer
+enum OLEDRasterOp {
+    OLED_ROP_OR,    // Set lit bitmap pixels
+    OLED_ROP_AND,   // Clear pixels that are dark in the bitmap
+    OLED_ROP_XOR,   // Invert pixels that are lit in the bitmap
+    OLED_ROP_COPY   // Replace the covered rectangle with the bitmap
+};
+
+// Logical pages in a portrait orientation
+#define OLED_MAX_PAGES (SCREEN_WIDTH / 8)
+
+// Framebuffer, drawing and flushing over a display backend (see
+// oled_backend.h). The backend is a template parameter so panel access
+// compiles down to direct calls; the common backends are instantiated in
+// OLED.cpp.
+template <class Backend>
+class OLEDDisplay {
 public:
     // Constructor
-    OLED();
+    explicit OLEDDisplay(const Backend& backend = Backend());
     
     // Initialization and display control
-    bool init();
+    bool init(uint32_t i2cClock = OLED_I2C_CLOCK);
     void clearDisplay();
-    void updateDisplay();
+    void updateDisplay();   // Blocking: present() and flush the whole frame
+    // Power commands wait for a frame in flight so they never interleave
+    // with the flusher's traffic
     void displayOn();
     void displayOff();
+
+    // Double-buffered flushing. Drawing always goes to the back buffer;
+    // present() hands the changed regions to the front buffer and starts a
+    // flush. It returns false (and leaves the back buffer pending) when the
+    // previous frame is still being sent, so callers can skip the frame.
+    bool present();
+    bool flushStep(uint16_t maxBytes = OLED_FLUSH_STEP_BYTES); // True while still busy
+    bool isFlushBusy() const { return flushBusy.load(std::memory_order_acquire); }
+#ifdef ESP32
+    // Flush on a FreeRTOS task instead; flushStep() then only reports busy
+    bool startFlushTask(uint8_t core = 0);
+#endif
     
+    // Orientation in 90-degree clockwise steps; 1 and 3 are portrait
+    // (64x128). The framebuffer stays in logical orientation and is rotated
+    // into the panel's layout as frames are presented. Mirroring flips the
+    // logical x axis. Changing orientation clears the screen.
+    void setRotation(uint8_t rotation, bool mirror = false);
+    uint8_t getRotation() const { return rotation; }
+    int getWidth() const { return logicalWidth; }
+    int getHeight() const { return logicalHeight; }
+
     // Drawing functions
     void setPixel(int x, int y, bool white = true);
     void drawLine(int x0, int y0, int x1, int y1);
     void drawRect(int x, int y, int width, int height, bool fill = false);
     void drawCircle(int x, int y, int radius, bool fill = false);
+    void fillArea(int x0, int y0, int x1, int y1, bool white = true); // Inclusive corners
     void drawString(int x, int y, const char* str);
     void drawString(int x, int y, String str);
 
+    // Page-packed bitmaps (see icons.h), at any pixel position, clipped to
+    // the screen
+    void drawBitmap(int x, int y, const uint8_t* bitmap, int width, int height,
+                    OLEDRasterOp rop = OLED_ROP_OR);
+    void drawBitmap(int x, int y, const OLEDBitmap& bitmap, OLEDRasterOp rop = OLED_ROP_OR);
+
+    // Text font (Font5x7 by default) and layout without a trial render
+    void setFont(const OLEDFont& font);
+    const OLEDFont& getFont() const { return *font; }
+    int measureString(const char* str) const;
+
+    // Console mode: a scrolling log of one text line per page. Appending a
+    // line rewrites only that page and scrolls with the display start-line
+    // register, so each new line costs one 128-byte page on the bus.
+    void beginConsole();
+    void consolePrintln(const char* line);
+    void consolePrintln(String line);
+    void endConsole();
+    bool isConsoleMode() const { return consoleActive; }
+
+    // Scroll a page-aligned region left by count columns, blanking the columns
+    // that move in on the right
+    void shiftPagesLeft(int x, int page, int width, int pages, int count = 1);
+
+    // Layers: snapshot the framebuffer, or copy a rectangle of a snapshot back
+    void saveLayer(uint8_t* layer) const;
+    void restoreRect(const uint8_t* layer, int x, int y, int width, int height);
+    // Combine a whole snapshot into the framebuffer (COPY restores it)
+    void compositeLayer(const uint8_t* layer, OLEDRasterOp rop);
+    // Invert every pixel
+    void invertDisplay();
+
+    // Flush statistics (cumulative since init or last reset)
+    uint32_t getBytesSent() const { return bytesSent; }
+    uint32_t getBytesSkipped() const { return bytesSkipped; }
+    uint32_t getTransactions() const { return panel.getTransactions(); }
+    // Bus time and data bytes of the most recently completed frame
+    uint32_t getLastFrameMicros() const { return lastFrameMicros; }
+    uint16_t getLastFrameBytes() const { return lastFrameBytes; }
+    void resetFlushStats();
+
+    // Also send every presented frame (in panel layout, with its start line)
+    // to a ScreenMirror, e.g. over Serial; nullptr turns mirroring off. The
+    // flusher sends each frame once it is on the panel.
+    void setScreenMirror(ScreenMirror* mirror);
+
 private:
-    uint8_t displayBuffer[BUFFER_SIZE];
+    Backend panel;
+    // Aligned for the framebuffer kernels
+    alignas(16) uint8_t displayBuffer[BUFFER_SIZE];  // Back buffer, target of all drawing
+    alignas(16) uint8_t frontBuffer[BUFFER_SIZE];    // Last presented frame, source of flushes
+    alignas(16) uint8_t panelBuffer[BUFFER_SIZE];    // Copy of what the panel currently shows
+    bool panelValid;                     // False until panelBuffer matches the panel
+
+    // Per-page dirty column ranges; min > max means the page is clean
+    uint8_t dirtyMin[OLED_MAX_PAGES];    // Back buffer vs. front buffer, logical pages
+    uint8_t dirtyMax[OLED_MAX_PAGES];
+    uint8_t frontMin[SCREEN_PAGES];      // Front buffer vs. panel
+    uint8_t frontMax[SCREEN_PAGES];
+
+    // In-flight flush state. flushBusy hands the front buffer and the flush
+    // state between present() and the flusher, which may be another task:
+    // each side releases it after its last write and acquires it before
+    // its first read.
+    std::atomic<bool> flushBusy;
+    uint8_t flushPageIdx;
+    int16_t flushX;                      // Next column to send, -1 if page not started
+    int16_t flushEnd;
+    uint16_t frameSent;
+    int8_t startLinePending;             // Start line to apply with the next frame, -1 if none
+    int8_t startLineInFlight;            // Start line to apply once this frame is sent
+    uint8_t startLine;                   // Start line as of the last presented frame
+    uint32_t frameMicros;
+    uint32_t lastFrameMicros;
+    uint16_t lastFrameBytes;
+
+    uint32_t bytesSent;
+    uint32_t bytesSkipped;
+
+    bool consoleActive;
+    uint8_t consoleHead;                 // Page the next line is written to
+    uint8_t consoleLines;
+
+    const OLEDFont* font;
+    ScreenMirror* screenMirror;
+
+    // Logical to panel mapping: swap x/y, then flip panel columns/rows
+    uint8_t rotation;
+    bool swapAxes;
+    bool flipX;
+    bool flipY;
+    uint8_t logicalWidth;
+    uint8_t logicalHeight;
+    uint8_t logicalPages;
+#ifdef ESP32
+    TaskHandle_t flushTask;
+    static void flushTaskMain(void* arg);
+#endif
     
     // Low-level functions
-    void sendCommand(uint8_t cmd);
-    void sendData(uint8_t data);
-    void resetDisplay();
+    void sendCommand(uint8_t cmd) { panel.sendCommand(cmd); }
+    void markDirty(uint8_t page, uint8_t x0, uint8_t x1);
+    void markAllDirty();
+    void markFront(uint8_t page, uint8_t x0, uint8_t x1);
+    void presentSpan(uint8_t page, uint8_t x0, uint8_t x1);
+    bool beginFlushPage();
+    bool flushSlice(uint16_t maxBytes);
+    void waitFlushIdle();
     
     // Internal drawing helpers
     void drawChar(int x, int y, char c);
@@ -71,4 +189,10 @@ private:
     void fillRect(int x, int y, int width, int height);
 };
 
+// Panel selected at build time, e.g. -DOLED_BACKEND=SH1106Backend
+#ifndef OLED_BACKEND
+#define OLED_BACKEND SSD1306Backend
+#endif
+typedef OLEDDisplay<OLED_BACKEND> OLED;
+
 #endif // OLED_H
\ No newline at end of file
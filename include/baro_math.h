@@ -0,0 +1,48 @@
+#ifndef BARO_MATH_H
+#define BARO_MATH_H
+
+#include <stdint.h>
+
+// International barometric formula:
+//   altitude  = 44330 * (1 - (p / p0)^(1/5.255))
+//   sea level = p / (1 - h / 44330)^5.255
+// baroAltitude(), baroSeaLevel() and baroAltitudeBatch() use powf. Build
+// with -DBARO_MATH_FAST to route them through the powf-free versions below
+// instead. That path is opt-in because it is unmeasured on the target: on
+// an x86 host it is slower than libm (about 30 ns vs 14 ns per altitude),
+// and it has not been timed against newlib's powf on the ESP32-S3.
+//
+// The powf-free versions evaluate x^y as exp(y * ln x): ln from the
+// mantissa through an atanh series (|s| <= 0.172 after range reduction),
+// exp through a degree-7 Taylor polynomial after splitting off a power of
+// two. Everything stays in single precision. Accuracy against the powf
+// formula over -500 m to 9000 m (p0 = 101325 Pa, checked by
+// tools/baro_math_check.cpp):
+//   baroAltitudeFast()  within 0.01 m
+//   baroSeaLevelFast()  within 0.1 Pa (powf: 0.05 Pa)
+//   baroAltitudeCm()    within 1 cm (integer only)
+// Most of that is float rounding, which powf is subject to as well.
+
+#define BARO_EXPONENT       0.190294957f  // 1 / 5.255
+#define BARO_SCALE_M        44330.0f
+
+float baroLog(float x);                    // Natural log, x > 0
+float baroExp(float x);                    // e^x, |x| < 87
+float baroPow(float x, float y);           // x^y, x > 0
+
+float baroAltitude(float pressurePa, float seaLevelPa);
+float baroSeaLevel(float pressurePa, float altitudeM);
+// Always built, so the check can compare them with powf in any build
+float baroAltitudeFast(float pressurePa, float seaLevelPa);
+float baroSeaLevelFast(float pressurePa, float altitudeM);
+
+// Convert a pressure history buffer to altitudes (altitudeM may alias
+// pressurePa); the division by p0 is hoisted out of the loop
+void baroAltitudeBatch(const float* pressurePa, float* altitudeM, uint16_t count,
+                       float seaLevelPa);
+
+// Integer-only altitude in centimetres for callers without the FPU (ISRs,
+// fixed-point filters). The pressure ratio is clamped to [0.2, 2].
+int32_t baroAltitudeCm(int32_t pressurePa, int32_t seaLevelPa);
+
+#endif // BARO_MATH_H
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "i2c_device.h"
 
 // BMP180 I2C address
 #define BMP180_ADDR 0x77
@@ -21,6 +22,10 @@
 #define BMP180_REG_CAL_MB 0xBA
 #define BMP180_REG_CAL_MC 0xBC
 #define BMP180_REG_CAL_MD 0xBE
+#define BMP180_REG_CHIP_ID 0xD0
+#define BMP180_CHIP_ID 0x55
+#define BMP180_CAL_BYTES 22     // AC1 (0xAA) through MD (0xBF), big-endian
+#define BMP180_CAL_CHECK_BYTES 6 // AC1..AC3, compared with the cache at boot
 
 // BMP180 commands
 #define BMP180_CMD_TEMP 0x2E
@@ -35,37 +40,162 @@
 #define BMP180_OSS_HIGHRES 2
 #define BMP180_OSS_ULTRAHIGHRES 3
 
+// Keep the calibration block in NVS so warm boots skip reading it. begin()
+// first reads AC1..AC3 from the chip and uses the cached block only if they
+// match, so a swapped sensor is read in full and replaces the cache.
+#ifndef BMP180_CAL_CACHE
+#if defined(ARDUINO_ARCH_ESP32)
+#define BMP180_CAL_CACHE 1
+#else
+#define BMP180_CAL_CACHE 0
+#endif
+#endif
+
+// Maximum conversion times from the datasheet, in microseconds
+#define BMP180_TEMP_CONVERSION_US 4500
+
+// Conversion in progress on the sensor
+enum BMP180Conversion {
+    BMP180_CONV_NONE,
+    BMP180_CONV_TEMPERATURE,
+    BMP180_CONV_PRESSURE
+};
+
+// Sea-level references a sample can carry altitudes for
+#define BMP180_MAX_ALTITUDES 4
+
+// One temperature + one pressure conversion, with the altitude for each
+// sea-level reference it was taken against
+struct BMP180Sample {
+    bool valid;
+    float temperature;                       // °C
+    float pressure;                          // Pa, compensated
+    uint32_t timestamp;                      // millis() when it completed
+    uint8_t oss;                             // Oversampling setting used
+    uint8_t averaged;                        // Pressure conversions averaged
+    uint8_t altitudeCount;
+    float altitude[BMP180_MAX_ALTITUDES];    // m, same order as the references
+};
+
 class BMP180 {
 private:
-    TwoWire* _wire;
-    uint8_t _oss;  // Oversampling setting
+    I2CDevice _dev;
+    uint8_t _oss;  // Oversampling setting of the current/last pressure conversion
+    uint8_t _nextOss;           // Applied when the next pressure conversion starts
+    uint8_t _averaging;         // Pressure conversions per tick() sample
+    uint8_t _avgCount;
+    int32_t _avgSum;
     
     // Calibration coefficients
     int16_t ac1, ac2, ac3, b1, b2, mb, mc, md;
     uint16_t ac4, ac5, ac6;
+    bool _calFromCache;
+
+    // I2C transfers spent in begin() and in the last tick() sample
+    uint32_t _bootTransactions;
+    uint32_t _cycleTransactions;
+    uint32_t _sampleTransactions;
+
+    // Non-blocking conversion state
+    BMP180Conversion _conversion;
+    uint32_t _convStart;        // micros() when the conversion was started
+    uint32_t _convTime;         // Its datasheet conversion time
+    bool _cycleStarted;
+    uint32_t _cycleStart;       // millis() of the last tick() cycle start
+    BMP180Sample _last;         // Last completed tick() sample
+
+    // Temperature terms reused by pressure reads until the refresh policy
+    // asks for a new temperature conversion
+    bool _tempValid;
+    uint32_t _tempMillis;       // millis() of the cached temperature
+    uint16_t _pressureReads;    // Pressure reads since then
+    uint16_t _tempEveryReads;   // Refresh after this many pressure reads (0 = never)
+    uint32_t _tempMaxAgeMs;     // Refresh once this old (0 = never)
+    int32_t _B5;
+    int32_t _B6;
+    int32_t _B3Base;            // AC1 * 4 + X3, so B3 can follow the OSS
+    uint32_t _B4;
     
     // Private methods
     bool readCalibrationData();
-    void writeRegister(uint8_t reg, uint8_t value);
-    uint8_t readRegister8(uint8_t reg);
-    uint16_t readRegister16(uint8_t reg);
+    bool parseCalibration(const uint8_t* block);
+    bool loadCachedCalibration(uint8_t* block);
+    bool chipMatchesCalibration(const uint8_t* block);
+    void storeCachedCalibration(const uint8_t* block);
     int32_t readRawTemperature();
     int32_t readRawPressure();
     int32_t computeB5(int32_t UT);
+    void updateTemperature(int32_t UT);
+    int32_t compensatePressure(int32_t UP) const;
+    BMP180Sample makeSample(int32_t pressure, uint8_t averaged);
+    void waitForConversion();
 
 public:
     // Constructor
     BMP180();
     bool begin(TwoWire* wire, uint8_t oss = BMP180_OSS_ULTRAHIGHRES);
     bool isConnected();
+
+    // Oversampling can change between samples; a conversion already running
+    // finishes at its own setting
+    void setOversampling(uint8_t oss);
+    uint8_t getOversampling() const { return _nextOss; }
+    // Pressure conversions averaged into each tick() sample (1-16)
+    void setAveraging(uint8_t samples);
+    uint8_t getAveraging() const { return _averaging; }
+    static uint32_t pressureConversionTime(uint8_t oss);   // µs, datasheet maximum
     
+    // Blocking reads: start a conversion and wait it out. They abandon any
+    // tick() cycle in progress. Prefer sample() when more than one value
+    // is needed, as each call here runs its own conversions.
+    BMP180Sample sample(const float* seaLevelPressures = nullptr, uint8_t count = 0);
     float readTemperature();
     float readPressure();
     float readAltitude(float seaLevelPressure = 101325.0);
+
+    // Temperature refresh policy for pressure reads: a new temperature
+    // conversion runs after everyReads pressure reads or once the cached
+    // one is maxAgeMs old, whichever comes first (0 disables either limit).
+    // The default of (1, 0) converts temperature before every pressure.
+    void setTemperatureRefresh(uint16_t everyReads, uint32_t maxAgeMs = 0);
+    bool temperatureDue() const;
+    void invalidateTemperature() { _tempValid = false; }
+
+    // Non-blocking conversions: start one, poll conversionReady(), then fetch
+    // the raw result. Only one conversion can run at a time.
+    bool startTemperature();
+    bool startPressure();
+    bool isConverting() const { return _conversion != BMP180_CONV_NONE; }
+    bool conversionReady() const;
+    int32_t fetchRawTemperature();
+    int32_t fetchRawPressure();
+
+    // Call every loop: runs a temperature conversion (when the refresh policy
+    // says so) then a pressure conversion, never waiting on the sensor, and
+    // starts the next cycle intervalMs after the previous one started.
+    // Returns true when a new sample has completed.
+    bool tick(uint32_t intervalMs = 0);
+    float getTemperature() const { return _last.temperature; }  // °C, last tick() sample
+    float getPressure() const { return _last.pressure; }        // Pa, last tick() sample
+    uint32_t getSampleMillis() const { return _last.timestamp; }
+    // Last tick() sample with altitudes for the given references
+    BMP180Sample lastSample(const float* seaLevelPressures = nullptr, uint8_t count = 0) const;
+
+    // Standard barometric formula, without touching the sensor
+    static float pressureToAltitude(float pressurePa, float seaLevelPressure = 101325.0);
+    // Fill sample.altitude[] for up to BMP180_MAX_ALTITUDES references
+    static void computeAltitudes(BMP180Sample& sample, const float* seaLevelPressures, uint8_t count);
     
     // Raw data access
     int32_t getRawTemperature();
     int32_t getRawPressure();
+
+    // Calibration cache and I2C cost
+    bool calibrationFromCache() const { return _calFromCache; }
+    void clearCalibrationCache();           // The next begin() reads the chip again
+    uint32_t getTransactions() const { return _dev.getTransactions(); }
+    uint32_t getBootTransactions() const { return _bootTransactions; }
+    uint32_t getSampleTransactions() const { return _sampleTransactions; }
 };
 
 #endif
\ No newline at end of file
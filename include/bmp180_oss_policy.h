@@ -0,0 +1,61 @@
+#ifndef BMP180_OSS_POLICY_H
+#define BMP180_OSS_POLICY_H
+
+#include <Arduino.h>
+#include "bmp180.h"
+
+// Typical RMS pressure noise per oversampling setting (datasheet), Pa
+#define BMP180_NOISE_PA { 6.0f, 5.0f, 4.0f, 3.0f }
+
+// I2C and loop polling time added to each conversion, ms
+#define BMP180_CONVERSION_OVERHEAD_MS 2.0f
+
+// What to run for the next sample
+struct BMP180OssChoice {
+    uint8_t oss;
+    uint8_t samples;        // Pressure conversions to average
+    float timeMs;           // Expected time for the whole sample
+    float noisePa;          // Expected RMS noise of the averaged pressure
+    bool moving;
+};
+
+// Picks the oversampling setting and the number of averaged conversions for
+// each sample from a time budget per sample and a noise target:
+//  - stationary: the fewest conversions that meet the noise target within
+//    the budget, which favours a high OSS with averaging. If nothing meets
+//    the target, the quietest choice that fits.
+//  - moving: a single conversion at the OSS with the lowest noise for the
+//    time spent (noise * sqrt(time)), i.e. a low OSS at a high rate, and
+//    the downstream filter does the averaging.
+// Motion is read from the vertical speed with hysteresis: it starts above
+// the threshold and ends after the speed stays below half of it for holdMs.
+class BMP180OssPolicy {
+public:
+    BMP180OssPolicy(float budgetMs = 100.0f, float noiseTargetPa = 2.0f);
+
+    void setBudget(float budgetMs) { _budgetMs = budgetMs; }
+    void setNoiseTarget(float noisePa) { _noiseTargetPa = noisePa; }
+    void setMotion(float thresholdMps, uint32_t holdMs = 3000);
+
+    // Update the motion state and pick the next sample's settings
+    BMP180OssChoice choose(float verticalSpeed, uint32_t nowMs);
+    void apply(BMP180& sensor, const BMP180OssChoice& choice) const;
+
+    const BMP180OssChoice& getChoice() const { return _choice; }
+    uint32_t getSamplesAt(uint8_t oss) const { return _samplesAt[oss & 3]; }
+
+private:
+    float _budgetMs;
+    float _noiseTargetPa;
+    float _threshold;       // m/s
+    uint32_t _holdMs;
+
+    bool _moving;
+    uint32_t _stillSince;
+    BMP180OssChoice _choice;
+    uint32_t _samplesAt[4];  // Samples chosen at each OSS
+
+    static float conversionMs(uint8_t oss);
+};
+
+#endif // BMP180_OSS_POLICY_H
@@ -0,0 +1,56 @@
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <Arduino.h>
+#include "OLED.h"
+
+#define DASHBOARD_MAX_LABELS 8
+#define DASHBOARD_MAX_FIELDS 8
+#define DASHBOARD_MAX_CHARS  21   // 128 px / 6 px per Font5x7 character
+
+// Two-layer text screen. Labels are static chrome rendered once into a cached
+// base layer; fields are text regions that are redrawn (on top of the base
+// layer) only when their text changes. Nothing is flushed here - callers
+// still present()/updateDisplay() the OLED, which then sends only the bytes
+// of fields that changed. Display is an OLEDDisplay; the backends are
+// instantiated in dashboard.cpp.
+template <class Display>
+class BasicDashboard {
+public:
+    BasicDashboard(Display& display);
+
+    // Layout, set up before begin()
+    bool addLabel(int x, int y, const char* text);
+    // Field id, or -1 if full. The field is drawn in its own font.
+    int  addField(int x, int y, uint8_t maxChars, const OLEDFont& font = Font5x7);
+
+    // Render the chrome, cache it as the base layer and blank all fields
+    void begin();
+
+    // Re-render the field only if the text differs from what is shown
+    bool setField(int id, const char* text);
+    bool setFieldf(int id, const char* format, ...);
+
+private:
+    struct Label {
+        int16_t x, y;
+        const char* text;
+    };
+    struct Field {
+        int16_t x, y;
+        uint8_t maxChars;
+        const OLEDFont* font;
+        char text[DASHBOARD_MAX_CHARS + 1];
+    };
+
+    Display& _display;
+    alignas(16) uint8_t baseLayer[BUFFER_SIZE];
+    Label labels[DASHBOARD_MAX_LABELS];
+    Field fields[DASHBOARD_MAX_FIELDS];
+    uint8_t labelCount;
+    uint8_t fieldCount;
+};
+
+typedef BasicDashboard<OLED> Dashboard;
+
+#endif // DASHBOARD_H
@@ -0,0 +1,33 @@
+#ifndef FB_KERNELS_H
+#define FB_KERNELS_H
+
+#include <stdint.h>
+
+// Byte-array kernels for framebuffer-wide work (clearing, inverting, layer
+// compositing and diffing for dirty tracking). On x86 hosts they run 16
+// bytes at a time with SSE2; on the ESP32 and elsewhere they are plain byte
+// loops. The byte loops double as the reference: the vector path is only
+// enabled once fbKernelsInit() has cross-checked it against them. Buffers
+// give the best results 16-byte aligned.
+
+// Run the cross-check and enable the vector path if it passes
+bool fbKernelsInit();
+bool fbKernelsSelfCheck();               // Vector path vs. reference, on random data
+const char* fbKernelsBackend();          // "sse2" or "scalar"
+void fbKernelsUseSimd(bool enable);      // For benchmarking; ignored without a vector path
+bool fbKernelsSimdEnabled();
+
+void fbInvert(uint8_t* dst, uint16_t count);
+void fbOr(uint8_t* dst, const uint8_t* src, uint16_t count);
+void fbAnd(uint8_t* dst, const uint8_t* src, uint16_t count);
+void fbXor(uint8_t* dst, const uint8_t* src, uint16_t count);
+// dst = (dst & ~mask) | (src & mask), the same mask for every byte
+void fbMaskedCopy(uint8_t* dst, const uint8_t* src, uint8_t mask, uint16_t count);
+
+// First and last index where (a ^ b) & mask is non-zero; false if none
+bool fbDiffSpan(const uint8_t* a, const uint8_t* b, uint8_t mask, uint16_t count,
+                uint16_t* first, uint16_t* last);
+// First and last non-zero byte; false if all zero
+bool fbNonZeroSpan(const uint8_t* data, uint16_t count, uint16_t* first, uint16_t* last);
+
+#endif // FB_KERNELS_H
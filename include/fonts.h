@@ -0,0 +1,38 @@
+#ifndef FONTS_H
+#define FONTS_H
+
+#include <Arduino.h>
+
+// Largest glyph height supported by the renderer, in 8-row pages
+#define FONT_MAX_PAGES 3
+
+// One glyph: `width` columns starting at `offset` in the font bitmap. Column
+// bytes are LSB-at-top; multi-page glyphs store each page as a run of
+// `stride` bytes, top page first.
+struct OLEDGlyph {
+    uint16_t offset;
+    uint8_t width;
+    uint8_t advance;  // Cursor step, including spacing
+};
+
+// Font tables are generated at compile time and live in flash. Characters
+// outside [first, last] render as the space glyph when the font has one.
+struct OLEDFont {
+    char first;
+    char last;
+    uint8_t height;   // Pixel rows actually used by the glyphs
+    uint8_t pages;    // Bytes per glyph column
+    uint8_t stride;   // Bytes between the pages of one glyph
+    const uint8_t* bitmap;
+    const OLEDGlyph* glyphs;
+};
+
+extern const OLEDFont Font5x7;          // Fixed 6 px advance, ASCII 32-126 (default)
+extern const OLEDFont Font5x7Prop;      // Same glyphs, proportional spacing
+extern const OLEDFont FontDigits10x14;  // 2x digits for readouts, ASCII 32-57
+extern const OLEDFont FontDigits15x21;  // 3x digits for readouts, ASCII 32-57
+
+const OLEDGlyph& fontGlyph(const OLEDFont& font, char c);
+uint16_t fontTextWidth(const OLEDFont& font, const char* str);
+
+#endif // FONTS_H
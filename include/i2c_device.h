@@ -0,0 +1,49 @@
+#ifndef I2C_DEVICE_H
+#define I2C_DEVICE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Big-endian field extraction from register blocks
+inline uint16_t be16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+inline int16_t be16s(const uint8_t* p) { return (int16_t)be16(p); }
+inline uint32_t be24(const uint8_t* p) {
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+// Register access to one device on a TwoWire bus. A register read is a
+// single combined transfer (register pointer write, repeated start, read),
+// and any number of consecutive registers can be read in one burst.
+// Every bus transfer is counted so drivers can report their I2C cost.
+class I2CDevice {
+public:
+    I2CDevice(TwoWire* wire = nullptr, uint8_t address = 0);
+
+    void begin(TwoWire* wire, uint8_t address);
+    bool isAttached() const { return _wire != nullptr; }
+    uint8_t getAddress() const { return _address; }
+
+    bool probe();                                              // Address-only write
+    bool writeRegister(uint8_t reg, uint8_t value);
+    bool writeCommand(uint16_t command);                       // 16-bit command, MSB first
+    bool readRegisters(uint8_t reg, uint8_t* dst, uint8_t len);
+    bool readCommand(uint16_t command, uint8_t* dst, uint8_t len);  // 16-bit command, then read
+    bool read(uint8_t* dst, uint8_t len);                      // No register pointer
+
+    uint32_t getTransactions() const { return transactions; }
+    uint32_t getBytesRead() const { return bytesRead; }
+    uint32_t getErrors() const { return errors; }
+    void resetStats();
+
+private:
+    TwoWire* _wire;
+    uint8_t _address;
+
+    uint32_t transactions;
+    uint32_t bytesRead;
+    uint32_t errors;
+
+    bool finishRead(uint8_t* dst, uint8_t len);
+};
+
+#endif // I2C_DEVICE_H
@@ -0,0 +1,20 @@
+#ifndef ICONS_H
+#define ICONS_H
+
+#include <Arduino.h>
+
+// Page-packed monochrome bitmap, laid out like the framebuffer: column bytes
+// LSB-at-top, each 8-row page stored as a run of `width` bytes, top page
+// first. Bits below `height` in the last page are ignored.
+struct OLEDBitmap {
+    uint8_t width;
+    uint8_t height;
+    const uint8_t* data;
+};
+
+// 16x16 status icons
+extern const OLEDBitmap IconSatellite;
+extern const OLEDBitmap IconSignalBars;
+extern const OLEDBitmap IconBattery;
+
+#endif // ICONS_H
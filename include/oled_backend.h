@@ -0,0 +1,198 @@
+#ifndef OLED_BACKEND_H
+#define OLED_BACKEND_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "ssd1306_emulator.h"
+
+// Pin definitions for Heltec ESP32 LoRa v3 (defaults for the I2C backends)
+#define VEXT_PIN 36
+#define SDA_PIN 17
+#define SCL_PIN 18
+#define RST_PIN 21
+#define I2C_ADDR 0x3C
+
+// Display dimensions
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define SCREEN_PAGES (SCREEN_HEIGHT / 8)
+#define BUFFER_SIZE (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
+
+// SSD1306 Commands
+#define SSD1306_DISPLAYOFF                  0xAE
+#define SSD1306_SETDISPLAYCLOCKDIV          0xD5
+#define SSD1306_SETMULTIPLEX                0xA8
+#define SSD1306_SETDISPLAYOFFSET            0xD3
+#define SSD1306_SETSTARTLINE                0x40
+#define SSD1306_CHARGEPUMP                  0x8D
+#define SSD1306_MEMORYMODE                  0x20
+#define SSD1306_SEGREMAP                    0xA0
+#define SSD1306_COMSCANDEC                  0xC8
+#define SSD1306_SETCOMPINS                  0xDA
+#define SSD1306_SETCONTRAST                 0x81
+#define SSD1306_SETPRECHARGE                0xD9
+#define SSD1306_SETVCOMDETECT               0xDB
+#define SSD1306_DISPLAYALLON_RESUME         0xA4
+#define SSD1306_NORMALDISPLAY               0xA6
+#define SSD1306_DISPLAYON                   0xAF
+#define SSD1306_COLUMNADDR                  0x21
+#define SSD1306_PAGEADDR                    0x22
+#define SSD1306_DEACTIVATE_SCROLL           0x2E
+
+// SH1106 commands that differ from the SSD1306. The SH1106 has no
+// horizontal addressing mode: data goes to one page at a time, starting at
+// a column set with two nibble commands, in a 132-column RAM whose visible
+// 128 columns start at column 2.
+#define SH1106_SETLOWCOLUMN                 0x00
+#define SH1106_SETHIGHCOLUMN                0x10
+#define SH1106_SETPAGE                      0xB0
+#define SH1106_DCDC                         0xAD
+#define SH1106_SETPUMPVOLTAGE               0x30
+#define SH1106_COLUMN_OFFSET                2
+
+// SSD1306 I2C control bytes (the SH1106 uses the same framing)
+#define SSD1306_CONTROL_CMD_STREAM          0x00
+#define SSD1306_CONTROL_CMD_SINGLE          0x80
+#define SSD1306_CONTROL_DATA_STREAM         0x40
+
+// OLED bus clocks. The SSD1306 is specified up to Fast-mode; Fast-mode Plus
+// is out of spec and has not been tried on a panel. The 400 kHz default is
+// that spec limit, not a rate measured on hardware. Host-counted estimates
+// for init plus one full frame, from the emulator's byte stream at 9 bits
+// per byte (about 1150 bus bytes, not timed): ~26 ms at 400 kHz, ~10 ms at
+// 1 MHz. getLastFrameMicros() reports the real bus time on the device.
+#define OLED_I2C_STANDARD                   100000
+#define OLED_I2C_FAST                       400000
+#define OLED_I2C_FAST_PLUS                  1000000
+#ifndef OLED_I2C_CLOCK
+#define OLED_I2C_CLOCK                      OLED_I2C_FAST
+#endif
+
+// Largest write transaction the I2C driver can buffer
+#ifdef I2C_BUFFER_LENGTH
+#define OLED_I2C_MAX_TRANSFER               I2C_BUFFER_LENGTH
+#else
+#define OLED_I2C_MAX_TRANSFER               32
+#endif
+
+// SSD1306/SH1106 transport over I2C. Command sequences go out as one
+// control-byte stream per transaction and display data in the largest chunks
+// the I2C driver buffers, instead of one transaction per command or per 16 bytes.
+class SSD1306I2C {
+public:
+    SSD1306I2C(TwoWire* wire, uint8_t address = I2C_ADDR);
+
+    bool begin(int sda, int scl, uint32_t clockHz);
+    void setClock(uint32_t clockHz);
+    bool probe();
+    void sendCommands(const uint8_t* cmds, uint16_t count);
+    void sendCommand(uint8_t cmd) { sendCommands(&cmd, 1); }
+    void sendData(const uint8_t* data, uint16_t count);
+
+    static const uint16_t MAX_PAYLOAD = OLED_I2C_MAX_TRANSFER - 1; // Minus control byte
+    uint32_t getTransactions() const { return transactions; }
+
+private:
+    TwoWire* _wire;
+    uint8_t _address;
+    uint32_t transactions;
+
+    void write(uint8_t control, const uint8_t* bytes, uint16_t count);
+};
+
+// Display backends. OLEDDisplay is a template over one of these, so every
+// call below resolves at compile time and inlines into the flush loop.
+// Each backend provides:
+//   bool begin(uint32_t clockHz)     power up, reset and configure the panel
+//   void sendCommands(cmds, count) / sendCommand(cmd)
+//   void setWindow(page, x0, x1)     route the next data bytes to page, x0..x1
+//   void sendData(data, count)
+//   uint32_t getTransactions() const
+
+// Shared power, reset and bus handling for I2C panels. Pins set to -1 are
+// not driven.
+class OLEDI2CBackend {
+public:
+    OLEDI2CBackend(TwoWire* wire = &Wire, uint8_t address = I2C_ADDR,
+                   int8_t sdaPin = SDA_PIN, int8_t sclPin = SCL_PIN,
+                   int8_t rstPin = RST_PIN, int8_t vextPin = VEXT_PIN);
+
+    void setClock(uint32_t clockHz) { bus.setClock(clockHz); }
+    void sendCommands(const uint8_t* cmds, uint16_t count) { bus.sendCommands(cmds, count); }
+    void sendCommand(uint8_t cmd) { bus.sendCommand(cmd); }
+    void sendData(const uint8_t* data, uint16_t count) { bus.sendData(data, count); }
+    uint32_t getTransactions() const { return bus.getTransactions(); }
+
+protected:
+    SSD1306I2C bus;
+    int8_t sda, scl, rst, vext;
+
+    bool powerUp(uint32_t clockHz);  // True if the panel answers on the bus
+};
+
+// SSD1306 in horizontal addressing mode: one column/page window per span
+class SSD1306Backend : public OLEDI2CBackend {
+public:
+    using OLEDI2CBackend::OLEDI2CBackend;
+
+    bool begin(uint32_t clockHz);
+    void setWindow(uint8_t page, uint8_t x0, uint8_t x1) {
+        const uint8_t window[] = {
+            SSD1306_COLUMNADDR, x0, x1,
+            SSD1306_PAGEADDR, page, page
+        };
+        bus.sendCommands(window, sizeof(window));
+    }
+};
+
+// SH1106 in its page addressing mode; the column pointer only runs to the
+// end of the page, which is all a span ever needs
+class SH1106Backend : public OLEDI2CBackend {
+public:
+    using OLEDI2CBackend::OLEDI2CBackend;
+
+    bool begin(uint32_t clockHz);
+    void setWindow(uint8_t page, uint8_t x0, uint8_t x1) {
+        (void)x1;
+        uint8_t col = x0 + SH1106_COLUMN_OFFSET;
+        const uint8_t window[] = {
+            (uint8_t)(SH1106_SETPAGE | page),
+            (uint8_t)(SH1106_SETLOWCOLUMN | (col & 0x0F)),
+            (uint8_t)(SH1106_SETHIGHCOLUMN | (col >> 4))
+        };
+        bus.sendCommands(window, sizeof(window));
+    }
+};
+
+// Host memory sink: the SSD1306 byte stream goes into an SSD1306Emulator
+// instead of the bus, one call per transaction, with no pins or delays
+class MemoryBackend {
+public:
+    MemoryBackend(SSD1306Emulator& emulator) : emulator(&emulator), transactions(0) {}
+
+    bool begin(uint32_t clockHz);
+    void setClock(uint32_t clockHz) { (void)clockHz; }
+    void sendCommands(const uint8_t* cmds, uint16_t count) {
+        transactions++;
+        emulator->receive(SSD1306_CONTROL_CMD_STREAM, cmds, count);
+    }
+    void sendCommand(uint8_t cmd) { sendCommands(&cmd, 1); }
+    void setWindow(uint8_t page, uint8_t x0, uint8_t x1) {
+        const uint8_t window[] = {
+            SSD1306_COLUMNADDR, x0, x1,
+            SSD1306_PAGEADDR, page, page
+        };
+        sendCommands(window, sizeof(window));
+    }
+    void sendData(const uint8_t* data, uint16_t count) {
+        transactions++;
+        emulator->receive(SSD1306_CONTROL_DATA_STREAM, data, count);
+    }
+    uint32_t getTransactions() const { return transactions; }
+
+private:
+    SSD1306Emulator* emulator;
+    uint32_t transactions;
+};
+
+#endif // OLED_BACKEND_H
@@ -0,0 +1,63 @@
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define RENDER_MAX_SUBSCRIPTIONS 16
+#define RENDER_SNAPSHOT_BYTES    96
+
+// Decides when a screen is worth redrawing. Values are subscribed by address;
+// shouldRender() returns true only when at least one of them changed since
+// the last rendered frame (or invalidate() was called), and never more often
+// than the configured maximum frame rate. Floats can be subscribed at the
+// resolution they are shown with, so noise below the last printed digit
+// does not count as a change.
+class RenderScheduler {
+public:
+    RenderScheduler(uint8_t maxFps = 10);
+
+    void setMaxFps(uint8_t maxFps);
+    bool subscribe(const void* value, uint8_t size);
+    template <typename T>
+    bool subscribe(const T& value) { return subscribe(&value, sizeof(T)); }
+    // Changed when round(value / resolution) changes, e.g. 0.1 for "%.1f"
+    bool subscribe(const float& value, float resolution);
+    void invalidate();  // Force a redraw at the next allowed slot
+
+    bool shouldRender(unsigned long now);
+    bool shouldRender() { return shouldRender(millis()); }
+
+    // Statistics
+    uint32_t getFramesRendered() const { return framesRendered; }
+    uint32_t getFramesSkipped() const { return framesSkipped; }     // Frame slots where nothing changed
+    uint32_t getFramesThrottled() const { return framesThrottled; } // Changes held back by the rate limit
+    void resetStats();
+
+private:
+    struct Subscription {
+        const uint8_t* value;
+        uint8_t size;
+        uint8_t offset;  // Into snapshot[]
+        float resolution; // > 0: a float, kept in snapshot[] as a rounded int32_t
+    };
+
+    Subscription subscriptions[RENDER_MAX_SUBSCRIPTIONS];
+    uint8_t snapshot[RENDER_SNAPSHOT_BYTES];
+    uint8_t subscriptionCount;
+    uint8_t snapshotUsed;
+
+    unsigned long minIntervalMs;
+    unsigned long lastRender;
+    unsigned long lastSlot;  // Last render or counted skip
+    bool dirty;
+    bool throttled;  // A change is waiting for the next allowed slot
+
+    uint32_t framesRendered;
+    uint32_t framesSkipped;
+    uint32_t framesThrottled;
+
+    bool add(const void* value, uint8_t size, float resolution);
+    bool pollChanges(bool refresh);
+};
+
+#endif // RENDER_SCHEDULER_H
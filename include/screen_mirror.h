@@ -0,0 +1,60 @@
+#ifndef SCREEN_MIRROR_H
+#define SCREEN_MIRROR_H
+
+#include <Arduino.h>
+#include "oled_backend.h"
+
+// Packet framing (all multi-byte fields little-endian):
+//   0xA5 0x5A | type | sequence | start line | payload length (2) | payload | checksum
+// type 'K' carries the RLE-coded frame and type 'D' carries the RLE-coded XOR
+// against the previous packet's frame. A 'D' with an empty payload means the
+// pixels did not change (only the start line may have). The checksum is the
+// 8-bit sum of everything from type through the payload.
+//
+// RLE control byte c: c < 0x80 is followed by c + 1 literal bytes; c >= 0x80
+// is followed by one byte repeated (c & 0x7F) + 3 times.
+#define SCREEN_MIRROR_SYNC0             0xA5
+#define SCREEN_MIRROR_SYNC1             0x5A
+#define SCREEN_MIRROR_KEYFRAME          'K'
+#define SCREEN_MIRROR_DELTA             'D'
+#define SCREEN_MIRROR_HEADER_SIZE       7
+#define SCREEN_MIRROR_MAX_PACKET        (SCREEN_MIRROR_HEADER_SIZE + BUFFER_SIZE + BUFFER_SIZE / 128 + 1)
+
+// Packets between keyframes, so a viewer can join (or recover) at any time
+#ifndef SCREEN_MIRROR_KEYFRAME_INTERVAL
+#define SCREEN_MIRROR_KEYFRAME_INTERVAL 50
+#endif
+
+// Streams presented OLED frames over a serial port for tools/oled_mirror.py.
+// Frames are panel-layout buffers (see OLED::setScreenMirror()). A packet is
+// only written if the port can buffer all of it, so mirroring never stalls
+// the caller; a dropped frame is simply folded into the next delta. Give the
+// port a transmit buffer (Serial.setTxBufferSize()) large enough for a keyframe.
+class ScreenMirror {
+public:
+    ScreenMirror(Print& out, bool dropWhenBusy = true);
+
+    bool sendFrame(const uint8_t* frame, uint8_t startLine); // False if dropped
+    void requestKeyframe() { keyframePending = true; }
+
+    uint32_t getFramesSent() const { return framesSent; }
+    uint32_t getFramesDropped() const { return framesDropped; }
+    uint32_t getBytesSent() const { return bytesSent; }
+
+private:
+    Print& _out;
+    bool _dropWhenBusy;
+    uint8_t reference[BUFFER_SIZE];      // Frame the viewer has
+    uint8_t packet[SCREEN_MIRROR_MAX_PACKET];
+    uint8_t sequence;
+    uint8_t sinceKeyframe;
+    bool keyframePending;
+
+    uint32_t framesSent;
+    uint32_t framesDropped;
+    uint32_t bytesSent;
+
+    uint16_t encode(const uint8_t* frame, const uint8_t* base, uint8_t* dst) const;
+};
+
+#endif // SCREEN_MIRROR_H
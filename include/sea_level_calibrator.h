@@ -0,0 +1,59 @@
+#ifndef SEA_LEVEL_CALIBRATOR_H
+#define SEA_LEVEL_CALIBRATOR_H
+
+#include <Arduino.h>
+
+#define SEA_LEVEL_MAX_SAMPLES   16
+#define SEA_LEVEL_MIN_PA        30000.0f    // Plausible station pressure range
+#define SEA_LEVEL_MAX_PA        120000.0f
+#define SEA_LEVEL_OUTLIER_PA    12.0f       // Never reject closer than this to the median
+
+enum SeaLevelCalState {
+    SEA_LEVEL_IDLE,
+    SEA_LEVEL_COLLECTING,
+    SEA_LEVEL_DONE,         // Result ready for takeResult()
+    SEA_LEVEL_FAILED
+};
+
+// Works out the sea-level pressure for a known altitude (e.g. from GPS) from
+// pressure samples fed in by the normal sampling path, so it never blocks.
+// Once the buffer is full, samples further than 4 MADs (and at least
+// SEA_LEVEL_OUTLIER_PA) from the median are dropped and collected again.
+// Implausible samples count as rejects too. Too many rejects or running past
+// the timeout fail the job instead of retrying forever.
+class SeaLevelCalibrator {
+public:
+    SeaLevelCalibrator(uint8_t samples = 8, uint8_t maxRejects = 8, uint32_t timeoutMs = 30000);
+
+    void start(float knownAltitudeM, uint32_t nowMs);
+    void cancel() { state = SEA_LEVEL_IDLE; }
+    void addSample(float pressurePa, uint32_t nowMs);
+    void update(uint32_t nowMs);          // Checks the timeout
+
+    SeaLevelCalState getState() const { return state; }
+    bool isRunning() const { return state == SEA_LEVEL_COLLECTING; }
+    // Hands over the result once, returning the job to idle
+    bool takeResult(float* seaLevelPa, float* knownAltitudeM = nullptr);
+
+    uint8_t getRejects() const { return rejects; }
+    float getSpreadPa() const { return spreadPa; }    // MAD of the accepted samples
+
+private:
+    uint8_t _samples;
+    uint8_t _maxRejects;
+    uint32_t _timeoutMs;
+
+    SeaLevelCalState state;
+    float altitudeM;
+    uint32_t startMs;
+    float buffer[SEA_LEVEL_MAX_SAMPLES];
+    uint8_t count;
+    uint8_t rejects;
+    float result;
+    float spreadPa;
+
+    void reject();
+    void evaluate();
+};
+
+#endif // SEA_LEVEL_CALIBRATOR_H
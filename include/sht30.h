@@ -2,19 +2,55 @@
 #define SHT30_H
 
 #include <Wire.h>
+#include "i2c_device.h"
 
+#define SHT30_ADDR 0x44
+#define SHT30_CMD_SINGLE_HIGH 0x2C06  // Single shot, high repeatability, clock stretching
+#define SHT30_CMD_FETCH       0xE000  // Latest periodic measurement
+#define SHT30_CMD_BREAK       0x3093  // Stop periodic mode
+#define SHT30_CMD_ART         0x2B32  // Periodic at 4 Hz with accelerated response time
+
+// Periodic measurement rates (measurements per second)
+enum SHT30Rate {
+  SHT30_RATE_0_5,
+  SHT30_RATE_1,
+  SHT30_RATE_2,
+  SHT30_RATE_4,
+  SHT30_RATE_10,
+  SHT30_RATE_ART
+};
+
+enum SHT30Repeatability {
+  SHT30_REPEAT_HIGH,
+  SHT30_REPEAT_MEDIUM,
+  SHT30_REPEAT_LOW
+};
+
+// In single-shot mode read() starts a measurement and waits for it. In
+// periodic mode the sensor measures on its own and read() only fetches the
+// latest result, one combined I2C transfer with no waiting; it returns
+// false when no new measurement is ready yet.
 class SHT30 {
 public:
   SHT30();
   bool begin(TwoWire *wire);
   bool read();
+
+  bool startPeriodic(SHT30Rate rate, SHT30Repeatability repeatability = SHT30_REPEAT_HIGH);
+  bool stopPeriodic();
+  bool isPeriodic() const { return _periodic; }
+  bool fetch();
   float getTemperature();
   float getHumidity();
+  uint32_t getTransactions() const { return _dev.getTransactions(); }
 
 private:
-  TwoWire *_wire;
+  I2CDevice _dev;
   float _temperature;
   float _humidity;
+  bool _periodic;
+
+  bool decode(const uint8_t* data);
 };
 
 #endif
\ No newline at end of file
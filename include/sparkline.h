@@ -0,0 +1,69 @@
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <Arduino.h>
+#include "OLED.h"
+
+#define SPARKLINE_MAX_SAMPLES SCREEN_WIDTH
+
+// Scrolling trend chart over the last `width` samples, one column per sample.
+// The chart occupies whole display pages. A new sample scrolls the existing
+// columns left by one and draws only the newest column; the full series is
+// re-plotted only when the autoscaled range has to change. Window min/max
+// are tracked with monotonic deques, so each sample is O(1) amortized.
+// Display is an OLEDDisplay; the backends are instantiated in sparkline.cpp.
+//
+// Scrolling changes nearly every column of the chart, so each sample costs
+// about width x pages bus bytes when the frame is flushed: ~590 for a full
+// 128x48 chart, ~45 for main.cpp's 30x16 trend (host-counted, see
+// tools/oled_render_check.cpp). Keep charts small or feed them slowly.
+template <class Display>
+class BasicSparkline {
+public:
+    BasicSparkline(Display& display, int x, int page, uint8_t width, uint8_t pages);
+
+    void addSample(float value);
+    void clear();
+
+    uint8_t getCount() const { return count; }
+    float getMin() const;
+    float getMax() const;
+    float getLatest() const;
+
+    uint32_t getReplots() const { return replots; }
+
+private:
+    Display& _display;
+    int16_t _x;
+    uint8_t _page;
+    uint8_t _width;
+    uint8_t _pages;
+
+    // Ring buffer of samples, indexed by sequence number % _width
+    float samples[SPARKLINE_MAX_SAMPLES];
+    uint32_t seq;       // Sequence number of the next sample
+    uint8_t count;
+
+    // Monotonic deques of sequence numbers (ring of _width entries each):
+    // values increasing front-to-back for the min, decreasing for the max
+    uint32_t minDeque[SPARKLINE_MAX_SAMPLES];
+    uint32_t maxDeque[SPARKLINE_MAX_SAMPLES];
+    uint8_t minHead, minLen;
+    uint8_t maxHead, maxLen;
+
+    // Range the columns on screen were drawn with
+    float scaleLo, scaleHi;
+    bool scaled;
+    uint32_t replots;
+
+    float sampleAt(uint32_t s) const { return samples[s % _width]; }
+    void pushDeques(float value);
+    bool updateScale();
+    int rowFor(float value) const;
+    void drawColumn(int column, uint32_t s);
+    void replot();
+};
+
+typedef BasicSparkline<OLED> Sparkline;
+
+#endif // SPARKLINE_H
@@ -0,0 +1,65 @@
+#ifndef SSD1306_EMULATOR_H
+#define SSD1306_EMULATOR_H
+
+#include <Arduino.h>
+
+#define SSD1306_EMU_WIDTH 128
+#define SSD1306_EMU_PAGES 8
+
+// In-memory SSD1306 stand-in. It decodes the same I2C byte stream the panel
+// receives (control bytes, commands with their arguments, display data) into
+// its own GDDRAM, so rendering and flushing can be checked and measured
+// without hardware. Attach it to a display through MemoryBackend.
+class SSD1306Emulator {
+public:
+    SSD1306Emulator();
+    void reset();
+
+    // One I2C write transaction, starting with the control byte
+    void receive(const uint8_t* bytes, uint16_t count);
+    void receive(uint8_t control, const uint8_t* payload, uint16_t count);
+
+    // Visible image, honouring the display start line
+    bool getPixel(int x, int y) const;
+    const uint8_t* getRAM() const { return &ram[0][0]; }
+    uint8_t getStartLine() const { return startLine; }
+    bool isDisplayOn() const { return displayOn; }
+    bool isInverted() const { return inverted; }
+
+    // Binary PBM (P4) of the visible image; lit pixels are written as 1 (black)
+    void writePBM(Print& out) const;
+    // FNV-1a hash of the visible image, for cheap golden-image comparisons
+    uint32_t frameHash() const;
+
+    // Traffic counters since the last reset
+    uint32_t getTransactions() const { return transactions; }
+    uint32_t getCommandBytes() const { return commandBytes; }
+    uint32_t getDataBytes() const { return dataBytes; }
+    void resetCounters();
+
+private:
+    uint8_t ram[SSD1306_EMU_PAGES][SSD1306_EMU_WIDTH];
+
+    // Addressing state
+    uint8_t memoryMode;   // 0 horizontal, 1 vertical, 2 page
+    uint8_t colStart, colEnd, col;
+    uint8_t pageStart, pageEnd, page;
+    uint8_t startLine;
+    bool displayOn;
+    bool inverted;
+
+    // Command parser state
+    uint8_t cmd[7];
+    uint8_t cmdLen;
+    uint8_t argsNeeded;
+
+    uint32_t transactions;
+    uint32_t commandBytes;
+    uint32_t dataBytes;
+
+    void command(uint8_t byte);
+    void applyCommand();
+    void data(uint8_t byte);
+};
+
+#endif // SSD1306_EMULATOR_H
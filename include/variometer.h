@@ -0,0 +1,75 @@
+#ifndef VARIOMETER_H
+#define VARIOMETER_H
+
+#include <Arduino.h>
+
+// Gains are given per sample at this interval and scaled by the actual dt,
+// so the filter's time constants stay the same when the sample rate changes
+#define VARIO_REFERENCE_MS      100
+#define VARIO_DEFAULT_ALPHA     0.08f
+#define VARIO_DEFAULT_BETA      0.002f
+
+// Gaps longer than this restart the filter from the next sample
+#define VARIO_MAX_GAP_MS        1000
+
+// Fixed-point alpha-beta filter turning a stream of barometric altitudes
+// into a smoothed altitude and a vertical speed:
+//   predicted = altitude + speed * dt
+//   residual  = measured - predicted
+//   altitude  = predicted + alpha * k * residual
+//   speed     = speed + beta * k^2 / dt * residual
+// with k = dt / VARIO_REFERENCE_MS (alpha * k is capped at 1). Altitude is
+// kept in Q8 centimetres and speed in Q8 cm/s, so updates are integer only.
+// Larger gains follow the sensor faster but pass more noise.
+//
+// setGains() characterises the gains by simulation at the reference
+// interval: the time a step takes to reach 63%, and how much of the sensor
+// noise reaches each output. While running, the sensor noise is estimated
+// from the residuals, so getters can report latency in ms and output noise
+// in cm at the current sample rate.
+class Variometer {
+public:
+    Variometer(float alpha = VARIO_DEFAULT_ALPHA, float beta = VARIO_DEFAULT_BETA);
+
+    void setGains(float alpha, float beta);
+    void reset();                                  // Restart from the next sample
+    bool update(int32_t altitudeCm, uint32_t nowMs);
+
+    bool isValid() const { return samples > 1; }
+    int32_t getAltitudeCm() const { return (int32_t)(altitudeQ8 >> 8); }
+    int32_t getSpeedCms() const { return (int32_t)(speedQ8 / 256); }
+    float getAltitude() const { return altitudeQ8 / 25600.0f; }    // m
+    float getSpeed() const { return speedQ8 / 25600.0f; }          // m/s
+    uint32_t getSamples() const { return samples; }
+
+    // Reported numbers
+    float getSampleIntervalMs() const { return intervalQ8 / 256.0f; }
+    float getAltitudeLatencyMs() const { return altitudeLagSamples * VARIO_REFERENCE_MS; }
+    float getSpeedLatencyMs() const { return speedLagSamples * VARIO_REFERENCE_MS; }
+    float getSensorNoiseCm() const;      // RMS noise of the raw altitudes
+    float getAltitudeNoiseCm() const;    // RMS noise left on getAltitude()
+    float getSpeedNoiseCms() const;      // RMS noise left on getSpeed()
+
+private:
+    uint32_t alphaRateQ32;       // alpha / VARIO_REFERENCE_MS, per ms of dt
+    uint32_t betaRateQ32;        // beta * 1000 / VARIO_REFERENCE_MS^2, per ms of dt
+
+    int64_t altitudeQ8;
+    int64_t speedQ8;
+    uint32_t lastMs;
+    uint32_t samples;
+
+    uint32_t intervalQ8;         // Average sample interval, ms
+    int64_t residualVarQ16;      // Average squared residual, cm^2
+
+    // From setGains(), at the reference interval: 63% rise time in samples
+    // for an altitude step and for the speed after a climb starts, and
+    // output/sensor noise ratios
+    float altitudeLagSamples;
+    float speedLagSamples;
+    float residualGain;          // residual variance / sensor variance
+    float altitudeGain;          // altitude variance / sensor variance
+    float speedGain;             // speed variance * dt^2 / sensor variance
+};
+
+#endif // VARIOMETER_H
@@ -83,9 +83,8 @@ void setup() {
   Serial.print("[OLED] Initializing display... ");
   if (display.init()) {
     Serial.println("✓ SUCCESS");
-    display.clearDisplay();
-    display.drawString(0, 0, "LoRa " + String(DEVICE_NAME));
-    display.drawString(0, 10, "Two-Way Ready");
+    display.beginConsole();
+    display.consolePrintln("LoRa " + String(DEVICE_NAME) + " Two-Way Ready");
     display.updateDisplay();
   } else {
     Serial.println("✗ FAILED");
@@ -395,45 +394,31 @@ String getNextSentence() {
   return String(sentences[index]);
 }
 
+// The OLED runs as a scrolling event log: each TX/RX event appends one line,
+// which rewrites a single display page instead of the whole frame
 void updateDisplay() {
-  display.clearDisplay();
+  char logLine[32];
   
   switch (currentDisplay) {
     case DISPLAY_WAITING:
-      display.drawString(0, 0, String(DEVICE_NAME) + " Ready");
-      display.drawString(0, 10, "TX:" + String(txSeq) + " RX:" + String(rxCount));
-      if (totalRxMessages > 0) {
-        float successRate = (float)validRxMessages / totalRxMessages * 100.0;
-        display.drawString(0, 20, "RX Rate:" + String(successRate, 0) + "%");
-      }
-      if (totalTxAttempts > 0) {
-        float txSuccessRate = (float)successfulTx / totalTxAttempts * 100.0;
-        display.drawString(0, 30, "TX Rate:" + String(txSuccessRate, 0) + "%");
-      }
-      break;
+      // Nothing new to log; the previous events stay on screen
+      return;
       
     case DISPLAY_SENDING:
-      display.drawString(0, 0, "Sending...");
-      display.drawString(0, 10, "TX #" + String(txSeq));
-      display.drawString(0, 20, "To: ALL");
-      display.drawString(0, 30, "Size:" + String(lastSentMessage.length()) + "b");
+      snprintf(logLine, sizeof(logLine), "TX #%lu %ub", txSeq, lastSentMessage.length());
       break;
       
     case DISPLAY_RECEIVED_MSG:
-      display.drawString(0, 0, "Received!");
-      display.drawString(0, 10, "From: " + String(lastReceivedMessage.indexOf("DEV1") > 0 ? "DEV1" : "DEV2"));
-      display.drawString(0, 20, "RX #" + String(rxCount));
-      display.drawString(0, 30, "TX #" + String(lastRxTxCount));
+      snprintf(logLine, sizeof(logLine), "RX #%lu %s TX#%lu", rxCount,
+               lastReceivedMessage.indexOf("DEV1") > 0 ? "DEV1" : "DEV2", lastRxTxCount);
       break;
       
     case DISPLAY_TX_FAILED:
-      display.drawString(0, 0, "TX Failed!");
-      display.drawString(0, 10, "Check radio");
-      display.drawString(0, 20, "TX #" + String(txSeq));
-      display.drawString(0, 30, "Retrying...");
+      snprintf(logLine, sizeof(logLine), "TX #%lu FAILED", txSeq);
       break;
   }
   
+  display.consolePrintln(logLine);
   display.updateDisplay();
 }
 
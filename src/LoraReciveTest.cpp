@@ -6,7 +6,6 @@ OLED display;
 
 // Timing control
 unsigned long lastMessageTime = 0;
-bool messageOnScreen = false;
 
 // Counter for received messages
 unsigned long messageCount = 0;
@@ -70,8 +69,8 @@ void setup() {
   if (display.init()) {
     Serial.println("✓ SUCCESS");
     Serial.println("[OLED] Display cleared and ready message shown");
-    display.clearDisplay();
-    display.drawString(0, 0, "LoRa Receiver Ready");
+    display.beginConsole();
+    display.consolePrintln("LoRa Receiver Ready");
     display.updateDisplay();
   } else {
     Serial.println("✗ FAILED");
@@ -249,51 +248,29 @@ void loop() {
     displayMessageQuality(rssi, snr);
     Serial.println();
 
-    // Show on OLED for 1 second
-    Serial.println("[UI] Updating display with received message");
+    // Append one line to the OLED packet log (only that page is redrawn)
+    Serial.println("[UI] Logging received message to display");
+    char logLine[32];
     if (parseSuccess) {
       Serial.print("[SENTENCE-PARSED] \"");
       Serial.print(sentence);
       Serial.print("\" from transmission #");
       Serial.println(txCount);
       
-      display.clearDisplay();
-      display.drawString(0, 0, "RX #" + String(messageCount));
-      display.drawString(0, 10, "TX #" + String(txCount) + " (" + String(attemptInGroup) + "/10)");
-      
-      // Show sentence on OLED (truncate if needed)
-      String oledSentence = sentence;
-      if (oledSentence.length() > 21) { // OLED character limit per line
-        oledSentence = oledSentence.substring(0, 18) + "...";
-      }
-      display.drawString(0, 20, oledSentence);
-      display.drawString(0, 30, "RSSI:" + String(rssi, 0) + " SNR:" + String(snr, 0));
+      snprintf(logLine, sizeof(logLine), "%lu %.0f %s", txCount, rssi, sentence.c_str());
     } else {
       Serial.println("[ERROR] Failed to parse sentence from message");
-      display.clearDisplay();
-      display.drawString(0, 0, "RX #" + String(messageCount));
-      display.drawString(0, 10, "Parse Error");
-      display.drawString(0, 20, msg.substring(0, 20));
-      display.drawString(0, 30, "RSSI:" + String(rssi, 0));
+      snprintf(logLine, sizeof(logLine), "ERR %.0f %s", rssi, msg.c_str());
     }
+    display.consolePrintln(logLine);
     display.updateDisplay();
 
     lastMessageTime = millis();
-    messageOnScreen = true;
     
   } else {
     Serial.println("No message");
   }
 
-  // After 1 second, switch to "Waiting..."
-  if (messageOnScreen && (millis() - lastMessageTime > 1000)) {
-    Serial.println("[UI] Updating display: 'Waiting...'");
-    display.clearDisplay();
-    display.drawString(0, 0, "Waiting...");
-    display.updateDisplay();
-    messageOnScreen = false;
-  }
-  
   // Show statistics periodically
   if (millis() - lastStatsDisplay > STATS_INTERVAL) {
     printReceptionStats();
@@ -1,187 +1,67 @@
 #include "OLED.h"
+#include "screen_mirror.h"
 
-// Standard 5x7 font for basic text rendering (ASCII 32-126)
-const uint8_t font5x7[][5] = {
-    {0x00, 0x00, 0x00, 0x00, 0x00}, // (space)
-    {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
-    {0x00, 0x07, 0x00, 0x07, 0x00}, // "
-    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
-    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
-    {0x23, 0x13, 0x08, 0x64, 0x62}, // %
-    {0x36, 0x49, 0x55, 0x22, 0x50}, // &
-    {0x00, 0x05, 0x03, 0x00, 0x00}, // '
-    {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
-    {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
-    {0x08, 0x2A, 0x1C, 0x2A, 0x08}, // *
-    {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
-    {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
-    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
-    {0x00, 0x60, 0x60, 0x00, 0x00}, // .
-    {0x20, 0x10, 0x08, 0x04, 0x02}, // /
-    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
-    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
-    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
-    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
-    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
-    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
-    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
-    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
-    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
-    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
-    {0x00, 0x36, 0x36, 0x00, 0x00}, // :
-    {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
-    {0x00, 0x08, 0x14, 0x22, 0x41}, // <
-    {0x14, 0x14, 0x14, 0x14, 0x14}, // =
-    {0x41, 0x22, 0x14, 0x08, 0x00}, // >
-    {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
-    {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
-    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
-    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
-    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
-    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
-    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
-    {0x7F, 0x09, 0x09, 0x01, 0x01}, // F
-    {0x3E, 0x41, 0x41, 0x51, 0x32}, // G
-    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
-    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
-    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
-    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
-    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
-    {0x7F, 0x02, 0x04, 0x02, 0x7F}, // M
-    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
-    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
-    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
-    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
-    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
-    {0x46, 0x49, 0x49, 0x49, 0x31}, // S
-    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
-    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
-    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
-    {0x7F, 0x20, 0x18, 0x20, 0x7F}, // W
-    {0x63, 0x14, 0x08, 0x14, 0x63}, // X
-    {0x03, 0x04, 0x78, 0x04, 0x03}, // Y
-    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
-    {0x00, 0x00, 0x7F, 0x41, 0x41}, // [
-    {0x02, 0x04, 0x08, 0x10, 0x20}, // "\"
-    {0x41, 0x41, 0x7F, 0x00, 0x00}, // ]
-    {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
-    {0x40, 0x40, 0x40, 0x40, 0x40}, // _
-    {0x00, 0x01, 0x02, 0x04, 0x00}, // `
-    {0x20, 0x54, 0x54, 0x54, 0x78}, // a
-    {0x7F, 0x48, 0x44, 0x44, 0x38}, // b
-    {0x38, 0x44, 0x44, 0x44, 0x20}, // c
-    {0x38, 0x44, 0x44, 0x48, 0x7F}, // d
-    {0x38, 0x54, 0x54, 0x54, 0x18}, // e
-    {0x08, 0x7E, 0x09, 0x01, 0x02}, // f
-    {0x08, 0x14, 0x54, 0x54, 0x3C}, // g
-    {0x7F, 0x08, 0x04, 0x04, 0x78}, // h
-    {0x00, 0x44, 0x7D, 0x40, 0x00}, // i
-    {0x20, 0x40, 0x44, 0x3D, 0x00}, // j
-    {0x00, 0x7F, 0x10, 0x28, 0x44}, // k
-    {0x00, 0x41, 0x7F, 0x40, 0x00}, // l
-    {0x7C, 0x04, 0x18, 0x04, 0x78}, // m
-    {0x7C, 0x08, 0x04, 0x04, 0x78}, // n
-    {0x38, 0x44, 0x44, 0x44, 0x38}, // o
-    {0x7C, 0x14, 0x14, 0x14, 0x08}, // p
-    {0x08, 0x14, 0x14, 0x18, 0x7C}, // q
-    {0x7C, 0x08, 0x04, 0x04, 0x08}, // r
-    {0x48, 0x54, 0x54, 0x54, 0x20}, // s
-    {0x04, 0x3F, 0x44, 0x40, 0x20}, // t
-    {0x3C, 0x40, 0x40, 0x20, 0x7C}, // u
-    {0x1C, 0x20, 0x40, 0x20, 0x1C}, // v
-    {0x3C, 0x40, 0x30, 0x40, 0x3C}, // w
-    {0x44, 0x28, 0x10, 0x28, 0x44}, // x
-    {0x0C, 0x50, 0x50, 0x50, 0x3C}, // y
-    {0x44, 0x64, 0x54, 0x4C, 0x44}, // z
-    {0x00, 0x08, 0x36, 0x41, 0x00}, // {
-    {0x00, 0x00, 0x7F, 0x00, 0x00}, // |
-    {0x00, 0x41, 0x36, 0x08, 0x00}, // }
-    {0x08, 0x08, 0x2A, 0x1C, 0x08}, // ->
-    {0x08, 0x1C, 0x2A, 0x08, 0x08}  // <-
-};
-
-OLED::OLED() {
+template <class Backend>
+OLEDDisplay<Backend>::OLEDDisplay(const Backend& backend)
+    : panel(backend), panelValid(false), flushBusy(false), flushPageIdx(0),
+      flushX(-1), flushEnd(-1), frameSent(0), startLinePending(-1), startLineInFlight(-1), startLine(0),
+      frameMicros(0), lastFrameMicros(0), lastFrameBytes(0), bytesSent(0), bytesSkipped(0),
+      consoleActive(false), consoleHead(0), consoleLines(0), font(&Font5x7),
+      screenMirror(nullptr), rotation(0), swapAxes(false), flipX(false), flipY(false),
+      logicalWidth(SCREEN_WIDTH), logicalHeight(SCREEN_HEIGHT), logicalPages(SCREEN_PAGES) {
     memset(displayBuffer, 0, BUFFER_SIZE);
+    memset(frontBuffer, 0, BUFFER_SIZE);
+    memset(panelBuffer, 0, BUFFER_SIZE);
+    memset(frontMin, SCREEN_WIDTH - 1, SCREEN_PAGES);
+    memset(frontMax, 0, SCREEN_PAGES);
+    memset(dirtyMin, SCREEN_WIDTH - 1, OLED_MAX_PAGES);
+    memset(dirtyMax, 0, OLED_MAX_PAGES);
+    markAllDirty();
+#ifdef ESP32
+    flushTask = nullptr;
+#endif
 }
 
-bool OLED::init() {
-    // Step 1: Power control
-    pinMode(VEXT_PIN, OUTPUT);
-    digitalWrite(VEXT_PIN, LOW);  // Enable power
-    delay(100);
-    // Step 2: Reset sequence
-    resetDisplay();
-    // Step 3: Initialize I2C
-    Wire.begin(SDA_PIN, SCL_PIN, 100000);
-    //Wire.setClock(400000);
-    delay(100);
-    
-    // Step 4: Check if device responds
-    Wire.beginTransmission(I2C_ADDR);
-    if (Wire.endTransmission() != 0) {
+template <class Backend>
+bool OLEDDisplay<Backend>::init(uint32_t i2cClock) {
+    fbKernelsInit();
+    // Power, reset, bus setup and the panel's init sequence
+    if (!panel.begin(i2cClock)) {
         return false;
     }
-    
-    // Step 5: Send initialization commands
-    sendCommand(SSD1306_DISPLAYOFF);
-    sendCommand(SSD1306_SETDISPLAYCLOCKDIV);
-    sendCommand(0xF0);
-    sendCommand(SSD1306_SETMULTIPLEX);
-    sendCommand(SCREEN_HEIGHT - 1);
-    sendCommand(SSD1306_SETDISPLAYOFFSET);
-    sendCommand(0x00);
-    sendCommand(SSD1306_SETSTARTLINE);
-    sendCommand(SSD1306_CHARGEPUMP);
-    sendCommand(0x14);
-    sendCommand(SSD1306_MEMORYMODE);
-    sendCommand(0x00);
-    sendCommand(SSD1306_SEGREMAP | 0x01);
-    sendCommand(SSD1306_COMSCANDEC);
-    sendCommand(SSD1306_SETCOMPINS);
-    sendCommand(0x12);
-    sendCommand(SSD1306_SETCONTRAST);
-    sendCommand(0xCF);
-    sendCommand(SSD1306_SETPRECHARGE);
-    sendCommand(0xF1);
-    sendCommand(SSD1306_SETVCOMDETECT);
-    sendCommand(0x40);
-    sendCommand(SSD1306_DISPLAYALLON_RESUME);
-    sendCommand(SSD1306_NORMALDISPLAY);
-    sendCommand(0x2E); // Stop scroll
-    sendCommand(SSD1306_DISPLAYON);
+    // Panel RAM content is unknown after reset, so the first flush sends everything
+    panelValid = false;
+    startLine = 0;
+    if (screenMirror != nullptr) screenMirror->requestKeyframe();
+    markAllDirty();
     clearDisplay();
     updateDisplay();
     return true;
 }
 
-void OLED::sendCommand(uint8_t cmd) {
-    Wire.beginTransmission(I2C_ADDR);
-    Wire.write(0x80); // Command mode
-    Wire.write(cmd);
-    Wire.endTransmission();
-}
-
-void OLED::resetDisplay() {
-    if (RST_PIN != -1) {
-        pinMode(RST_PIN, OUTPUT);
-        digitalWrite(RST_PIN, HIGH);
-        delay(1);
-        digitalWrite(RST_PIN, LOW);
-        delay(1);
-        digitalWrite(RST_PIN, HIGH);
-        delay(1);
-    }
-}
-
-void OLED::displayOn() {
+template <class Backend>
+void OLEDDisplay<Backend>::displayOn() {
+    waitFlushIdle();
     sendCommand(SSD1306_DISPLAYON);
 }
 
-void OLED::displayOff() {
+template <class Backend>
+void OLEDDisplay<Backend>::displayOff() {
+    waitFlushIdle();
     sendCommand(SSD1306_DISPLAYOFF);
 }
 
-void OLED::drawLine(int x0, int y0, int x1, int y1) {
+template <class Backend>
+void OLEDDisplay<Backend>::drawLine(int x0, int y0, int x1, int y1) {
+    // Axis-aligned lines are spans
+    if (y0 == y1) {
+        fillArea(min(x0, x1), y0, max(x0, x1), y0, true);
+        return;
+    }
+    if (x0 == x1) {
+        fillArea(x0, min(y0, y1), x0, max(y0, y1), true);
+        return;
+    }
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
     int sx = (x0 < x1) ? 1 : -1;
@@ -202,7 +82,8 @@ void OLED::drawLine(int x0, int y0, int x1, int y1) {
     }
 }
 
-void OLED::drawRect(int x, int y, int width, int height, bool fill) {
+template <class Backend>
+void OLEDDisplay<Backend>::drawRect(int x, int y, int width, int height, bool fill) {
     if (fill) {
         fillRect(x, y, width, height);
     } else {
@@ -213,7 +94,8 @@ void OLED::drawRect(int x, int y, int width, int height, bool fill) {
     }
 }
 
-void OLED::drawCircle(int x, int y, int radius, bool fill) {
+template <class Backend>
+void OLEDDisplay<Backend>::drawCircle(int x, int y, int radius, bool fill) {
     int f = 1 - radius;
     int ddF_x = 1;
     int ddF_y = -2 * radius;
@@ -262,78 +144,628 @@ void OLED::drawCircle(int x, int y, int radius, bool fill) {
     }
 }
 
-void OLED::drawHorizontalLine(int x, int y, int width) {
-    for (int i = 0; i < width; i++) {
-        setPixel(x + i, y);
+template <class Backend>
+void OLEDDisplay<Backend>::drawHorizontalLine(int x, int y, int width) {
+    fillArea(x, y, x + width - 1, y, true);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::drawVerticalLine(int x, int y, int height) {
+    fillArea(x, y, x, y + height - 1, true);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::fillRect(int x, int y, int width, int height) {
+    fillArea(x, y, x + width - 1, y + height - 1, true);
+}
+
+// Sets or clears the inclusive rectangle [x0,x1] x [y0,y1] page by page.
+// Each page gets one bit mask covering the rows it shares with the span;
+// fully covered pages are written with memset, partial ones OR/AND the mask
+// across the column range. Clipping happens once, up front.
+template <class Backend>
+void OLEDDisplay<Backend>::fillArea(int x0, int y0, int x1, int y1, bool white) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= logicalWidth) x1 = logicalWidth - 1;
+    if (y1 >= logicalHeight) y1 = logicalHeight - 1;
+    if (x0 > x1 || y0 > y1) return;
+
+    int lastPage = y1 >> 3;
+    for (int page = y0 >> 3; page <= lastPage; page++) {
+        uint8_t mask = 0xFF;
+        if (page == (y0 >> 3)) mask &= (uint8_t)(0xFF << (y0 & 7));
+        if (page == lastPage) mask &= (uint8_t)(0xFF >> (7 - (y1 & 7)));
+
+        uint8_t* row = &displayBuffer[page * logicalWidth];
+        if (mask == 0xFF) {
+            memset(row + x0, white ? 0xFF : 0x00, x1 - x0 + 1);
+        } else if (white) {
+            for (int x = x0; x <= x1; x++) row[x] |= mask;
+        } else {
+            for (int x = x0; x <= x1; x++) row[x] &= ~mask;
+        }
+        markDirty(page, x0, x1);
     }
 }
 
-void OLED::drawVerticalLine(int x, int y, int height) {
-    for (int i = 0; i < height; i++) {
-        setPixel(x, y + i);
+template <class Backend>
+void OLEDDisplay<Backend>::clearDisplay() {
+    // Only mark the column span of each page that actually held lit pixels
+    for (uint8_t page = 0; page < logicalPages; page++) {
+        uint8_t* row = &displayBuffer[page * logicalWidth];
+        uint16_t first, last;
+        if (!fbNonZeroSpan(row, logicalWidth, &first, &last)) continue;
+        memset(row + first, 0, last - first + 1);
+        markDirty(page, first, last);
     }
 }
 
-void OLED::fillRect(int x, int y, int width, int height) {
-    for (int i = 0; i < height; i++) {
-        drawHorizontalLine(x, y + i, width);
+template <class Backend>
+void OLEDDisplay<Backend>::beginConsole() {
+    clearDisplay();
+    consoleActive = true;
+    consoleHead = 0;
+    consoleLines = 0;
+    startLinePending = 0;
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::consolePrintln(const char* line) {
+    if (!consoleActive) beginConsole();
+
+    // In portrait the start-line register would scroll sideways, so a full
+    // console moves the text up a page in the framebuffer instead
+    if (swapAxes && consoleLines == logicalPages) {
+        memmove(displayBuffer, displayBuffer + logicalWidth, (logicalPages - 1) * logicalWidth);
+        for (uint8_t page = 0; page < logicalPages - 1; page++) {
+            markDirty(page, 0, logicalWidth - 1);
+        }
+    }
+
+    // One line per page needs the single-page font
+    const OLEDFont* userFont = font;
+    font = &Font5x7;
+    int y = consoleHead * 8;
+    fillArea(0, y, logicalWidth - 1, y + 7, false);
+    drawString(0, y, line);
+    font = userFont;
+
+    if (consoleLines < logicalPages) consoleLines++;
+    if (!swapAxes) {
+        consoleHead = (consoleHead + 1) % logicalPages;
+        // Once the ring is full the oldest line sits on the page after the
+        // newest one; start the display there so lines scroll up. Upside
+        // down, the panel's last row is the top of the screen.
+        if (consoleLines == logicalPages) {
+            startLinePending = (flipY ? (logicalPages - consoleHead) % logicalPages : consoleHead) * 8;
+        }
+    } else if (consoleHead < logicalPages - 1) {
+        consoleHead++;
     }
 }
 
-void OLED::clearDisplay() {
-    memset(displayBuffer, 0, BUFFER_SIZE);
+template <class Backend>
+void OLEDDisplay<Backend>::consolePrintln(String line) {
+    consolePrintln(line.c_str());
 }
 
-void OLED::setPixel(int x, int y, bool white) {
-    if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-        if (white) {
-            displayBuffer[x + (y >> 3) * SCREEN_WIDTH] |= (1 << (y & 7));
-        } else {
-            displayBuffer[x + (y >> 3) * SCREEN_WIDTH] &= ~(1 << (y & 7));
+template <class Backend>
+void OLEDDisplay<Backend>::endConsole() {
+    consoleActive = false;
+    startLinePending = 0;
+    clearDisplay();
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::shiftPagesLeft(int x, int page, int width, int pages, int count) {
+    int x0 = max(x, 0);
+    int x1 = min(x + width - 1, logicalWidth - 1);
+    int lastPage = min(page + pages - 1, logicalPages - 1);
+    if (x0 > x1 || count <= 0) return;
+    if (count > x1 - x0 + 1) count = x1 - x0 + 1;
+
+    for (int p = max(page, 0); p <= lastPage; p++) {
+        uint8_t* row = &displayBuffer[p * logicalWidth];
+        memmove(row + x0, row + x0 + count, x1 - x0 + 1 - count);
+        memset(row + x1 - count + 1, 0, count);
+        markDirty(p, x0, x1);
+    }
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::saveLayer(uint8_t* layer) const {
+    memcpy(layer, displayBuffer, BUFFER_SIZE);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::restoreRect(const uint8_t* layer, int x, int y, int width, int height) {
+    int x0 = max(x, 0);
+    int y0 = max(y, 0);
+    int x1 = min(x + width - 1, logicalWidth - 1);
+    int y1 = min(y + height - 1, logicalHeight - 1);
+    if (x0 > x1 || y0 > y1) return;
+
+    int lastPage = y1 >> 3;
+    for (int page = y0 >> 3; page <= lastPage; page++) {
+        uint8_t mask = 0xFF;
+        if (page == (y0 >> 3)) mask &= (uint8_t)(0xFF << (y0 & 7));
+        if (page == lastPage) mask &= (uint8_t)(0xFF >> (7 - (y1 & 7)));
+
+        uint8_t* row = &displayBuffer[page * logicalWidth];
+        const uint8_t* src = &layer[page * logicalWidth];
+        uint16_t first, last;
+        if (!fbDiffSpan(row + x0, src + x0, mask, x1 - x0 + 1, &first, &last)) continue;
+        fbMaskedCopy(row + x0 + first, src + x0 + first, mask, last - first + 1);
+        markDirty(page, x0 + first, x0 + last);
+    }
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::compositeLayer(const uint8_t* layer, OLEDRasterOp rop) {
+    alignas(16) uint8_t row[SCREEN_WIDTH];
+    for (uint8_t page = 0; page < logicalPages; page++) {
+        uint8_t* dst = &displayBuffer[page * logicalWidth];
+        const uint8_t* src = &layer[page * logicalWidth];
+        memcpy(row, dst, logicalWidth);
+        switch (rop) {
+            case OLED_ROP_AND:  fbAnd(row, src, logicalWidth); break;
+            case OLED_ROP_XOR:  fbXor(row, src, logicalWidth); break;
+            case OLED_ROP_COPY: memcpy(row, src, logicalWidth); break;
+            default:            fbOr(row, src, logicalWidth); break;
         }
+        uint16_t first, last;
+        if (!fbDiffSpan(row, dst, 0xFF, logicalWidth, &first, &last)) continue;
+        memcpy(dst + first, row + first, last - first + 1);
+        markDirty(page, first, last);
     }
 }
 
-void OLED::updateDisplay() {
-    sendCommand(SSD1306_COLUMNADDR);
-    sendCommand(0);
-    sendCommand(SCREEN_WIDTH - 1);
-    sendCommand(SSD1306_PAGEADDR);
-    sendCommand(0);
-    sendCommand((SCREEN_HEIGHT >> 3) - 1);
-    for (uint16_t i = 0; i < BUFFER_SIZE; i += 16) {
-        Wire.beginTransmission(I2C_ADDR);
-        Wire.write(0x40); // Data mode
-        for (uint8_t x = 0; x < 16 && (i + x) < BUFFER_SIZE; x++) {
-            Wire.write(displayBuffer[i + x]);
+template <class Backend>
+void OLEDDisplay<Backend>::invertDisplay() {
+    fbInvert(displayBuffer, logicalPages * logicalWidth);
+    markAllDirty();
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::setPixel(int x, int y, bool white) {
+    if (x >= 0 && x < logicalWidth && y >= 0 && y < logicalHeight) {
+        uint8_t* cell = &displayBuffer[x + (y >> 3) * logicalWidth];
+        uint8_t value = white ? (*cell | (1 << (y & 7))) : (*cell & ~(1 << (y & 7)));
+        if (value != *cell) {
+            *cell = value;
+            markDirty(y >> 3, x, x);
         }
-        Wire.endTransmission();
     }
 }
 
-void OLED::drawChar(int x, int y, char c) {
-    // Allow full ASCII printable character range (32-126)
-    if (c < 32 || c > 126) c = 32; // Default to space for unsupported chars
-    const uint8_t* charData = font5x7[c - 32];
-    for (int i = 0; i < 5; i++) {
-        uint8_t line = charData[i];
-        for (int j = 0; j < 8; j++) {
-            if (line & (1 << j)) {
-                setPixel(x + i, y + j);
-            }
+template <class Backend>
+void OLEDDisplay<Backend>::markDirty(uint8_t page, uint8_t x0, uint8_t x1) {
+    if (x0 < dirtyMin[page]) dirtyMin[page] = x0;
+    if (x1 > dirtyMax[page]) dirtyMax[page] = x1;
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::markAllDirty() {
+    memset(dirtyMin, 0, logicalPages);
+    memset(dirtyMax, logicalWidth - 1, logicalPages);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::setScreenMirror(ScreenMirror* mirror) {
+    // The flusher sends the frames, so only swap the mirror between frames
+    waitFlushIdle();
+    screenMirror = mirror;
+    if (screenMirror != nullptr) screenMirror->requestKeyframe();
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::resetFlushStats() {
+    bytesSent = 0;
+    bytesSkipped = 0;
+}
+
+// Returns once no frame is in flight. Without a flush task the caller is
+// the flusher, so it finishes the frame itself. Afterwards the panel is
+// free for direct commands until the next present().
+template <class Backend>
+void OLEDDisplay<Backend>::waitFlushIdle() {
+#ifdef ESP32
+    if (flushTask != nullptr) {
+        while (isFlushBusy()) delay(1);
+        return;
+    }
+#endif
+    while (flushSlice(BUFFER_SIZE)) {}
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::updateDisplay() {
+    waitFlushIdle();
+    present();
+    waitFlushIdle();
+}
+
+template <class Backend>
+bool OLEDDisplay<Backend>::present() {
+    if (isFlushBusy()) return false;
+
+    bool changed = false;
+    for (uint8_t page = 0; page < logicalPages; page++) {
+        uint8_t x0 = dirtyMin[page];
+        uint8_t x1 = dirtyMax[page];
+        if (x0 > x1) continue;
+        presentSpan(page, x0, x1);
+        dirtyMin[page] = SCREEN_WIDTH - 1;
+        dirtyMax[page] = 0;
+        changed = true;
+    }
+    if (!changed && startLinePending < 0) return true;
+
+    if (startLinePending >= 0) startLine = startLinePending;
+
+    startLineInFlight = startLinePending;
+    startLinePending = -1;
+    flushPageIdx = 0;
+    flushX = -1;
+    frameSent = 0;
+    frameMicros = 0;
+    flushBusy.store(true, std::memory_order_release);
+#ifdef ESP32
+    if (flushTask != nullptr) xTaskNotifyGive(flushTask);
+#endif
+    return true;
+}
+
+// Transposes an 8x8 bit matrix held as 8 column bytes: bit k of in[i]
+// becomes bit i of out[k]. The block is processed as two 32-bit words in
+// three swap stages (2x2, 4x4, then the two halves) rather than bit by bit.
+static inline void transpose8x8(uint8_t* block) {
+    uint32_t lo = block[0] | (block[1] << 8) | (block[2] << 16) | ((uint32_t)block[3] << 24);
+    uint32_t hi = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+    uint32_t t;
+    t = (lo ^ (lo >> 7)) & 0x00AA00AA; lo ^= t ^ (t << 7);
+    t = (hi ^ (hi >> 7)) & 0x00AA00AA; hi ^= t ^ (t << 7);
+    t = (lo ^ (lo >> 14)) & 0x0000CCCC; lo ^= t ^ (t << 14);
+    t = (hi ^ (hi >> 14)) & 0x0000CCCC; hi ^= t ^ (t << 14);
+    t = (lo ^ (hi << 4)) & 0xF0F0F0F0; lo ^= t; hi ^= t >> 4;
+    for (uint8_t i = 0; i < 4; i++) {
+        block[i] = lo >> (8 * i);
+        block[i + 4] = hi >> (8 * i);
+    }
+}
+
+static inline uint8_t reverseBits(uint8_t b) {
+    b = (b >> 4) | (b << 4);
+    b = ((b & 0xCC) >> 2) | ((b & 0x33) << 2);
+    return ((b & 0xAA) >> 1) | ((b & 0x55) << 1);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::setRotation(uint8_t newRotation, bool mirror) {
+    rotation = newRotation & 3;
+    swapAxes = rotation & 1;
+    flipX = (rotation == 1 || rotation == 2);
+    flipY = (rotation >= 2);
+    // Mirroring flips the logical x axis, which lands on panel rows in portrait
+    if (mirror) {
+        if (swapAxes) flipY = !flipY;
+        else flipX = !flipX;
+    }
+    logicalWidth = swapAxes ? SCREEN_HEIGHT : SCREEN_WIDTH;
+    logicalHeight = swapAxes ? SCREEN_WIDTH : SCREEN_HEIGHT;
+    logicalPages = logicalHeight / 8;
+
+    // The old contents have no meaning in the new layout
+    consoleActive = false;
+    startLinePending = 0;
+    memset(displayBuffer, 0, BUFFER_SIZE);
+    memset(dirtyMin, SCREEN_WIDTH - 1, OLED_MAX_PAGES);
+    memset(dirtyMax, 0, OLED_MAX_PAGES);
+    markAllDirty();
+}
+
+// Copies a dirty back-buffer span into the front buffer in panel
+// orientation and widens the front dirty range to match. In portrait a
+// logical page becomes 8 panel columns and each 8-column block of it one
+// byte column group on a panel page, moved with a single transpose.
+template <class Backend>
+void OLEDDisplay<Backend>::presentSpan(uint8_t page, uint8_t x0, uint8_t x1) {
+    const uint8_t* src = &displayBuffer[page * logicalWidth];
+    if (!swapAxes) {
+        uint8_t panelPage = flipY ? SCREEN_PAGES - 1 - page : page;
+        uint8_t* dst = &frontBuffer[panelPage * SCREEN_WIDTH];
+        if (!flipX && !flipY) {
+            memcpy(dst + x0, src + x0, x1 - x0 + 1);
+            markFront(panelPage, x0, x1);
+            return;
+        }
+        for (int x = x0; x <= x1; x++) {
+            dst[flipX ? SCREEN_WIDTH - 1 - x : x] = flipY ? reverseBits(src[x]) : src[x];
+        }
+        if (flipX) markFront(panelPage, SCREEN_WIDTH - 1 - x1, SCREEN_WIDTH - 1 - x0);
+        else markFront(panelPage, x0, x1);
+        return;
+    }
+
+    uint8_t col0 = flipX ? SCREEN_WIDTH - 8 - page * 8 : page * 8;
+    for (int bx = x0 >> 3; bx <= (x1 >> 3); bx++) {
+        const uint8_t* in = src + bx * 8;
+        uint8_t block[8];
+        for (uint8_t i = 0; i < 8; i++) block[i] = in[flipY ? 7 - i : i];
+        transpose8x8(block);
+        uint8_t panelPage = flipY ? SCREEN_PAGES - 1 - bx : bx;
+        uint8_t* dst = &frontBuffer[panelPage * SCREEN_WIDTH + col0];
+        for (uint8_t k = 0; k < 8; k++) dst[flipX ? 7 - k : k] = block[k];
+        markFront(panelPage, col0, col0 + 7);
+    }
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::markFront(uint8_t page, uint8_t x0, uint8_t x1) {
+    if (x0 < frontMin[page]) frontMin[page] = x0;
+    if (x1 > frontMax[page]) frontMax[page] = x1;
+}
+
+// Claims the front-buffer dirty span of the current page and opens a column
+// window for it. Returns false if the page has nothing to send.
+template <class Backend>
+bool OLEDDisplay<Backend>::beginFlushPage() {
+    uint8_t page = flushPageIdx;
+    int x0 = frontMin[page];
+    int x1 = frontMax[page];
+    frontMin[page] = SCREEN_WIDTH - 1;
+    frontMax[page] = 0;
+    if (x0 > x1) return false;
+
+    // A draw followed by an erase (or clear + identical redraw) leaves the
+    // bytes unchanged, so trim the span against what the panel already shows
+    if (panelValid) {
+        const uint8_t* want = &frontBuffer[page * SCREEN_WIDTH];
+        const uint8_t* have = &panelBuffer[page * SCREEN_WIDTH];
+        uint16_t first, last;
+        if (!fbDiffSpan(want + x0, have + x0, 0xFF, x1 - x0 + 1, &first, &last)) return false;
+        x1 = x0 + last;
+        x0 += first;
+    }
+
+    panel.setWindow(page, x0, x1);
+    flushX = x0;
+    flushEnd = x1;
+    return true;
+}
+
+template <class Backend>
+bool OLEDDisplay<Backend>::flushStep(uint16_t maxBytes) {
+#ifdef ESP32
+    // The flush task owns the panel once it runs
+    if (flushTask != nullptr) return isFlushBusy();
+#endif
+    return flushSlice(maxBytes);
+}
+
+template <class Backend>
+bool OLEDDisplay<Backend>::flushSlice(uint16_t maxBytes) {
+    if (!isFlushBusy()) return false;
+
+    uint32_t stepStart = micros();
+    while (flushPageIdx < SCREEN_PAGES) {
+        if (flushX < 0 && !beginFlushPage()) {
+            flushPageIdx++;
+            continue;
         }
+        if (maxBytes == 0) break;
+
+        // The panel keeps its column pointer between transactions, so a page
+        // can be streamed across several flushStep() calls
+        uint16_t start = flushPageIdx * SCREEN_WIDTH + flushX;
+        uint16_t n = flushEnd - flushX + 1;
+        if (n > maxBytes) n = maxBytes;
+        panel.sendData(&frontBuffer[start], n);
+        memcpy(&panelBuffer[start], &frontBuffer[start], n);
+        flushX += n;
+        frameSent += n;
+        maxBytes -= n;
+        if (flushX <= flushEnd) break;
+        flushX = -1;
+        flushPageIdx++;
+    }
+    if (flushPageIdx < SCREEN_PAGES) {
+        frameMicros += micros() - stepStart;
+        return true;
+    }
+
+    // Scroll only after the new page content is in place
+    if (startLineInFlight >= 0) {
+        sendCommand(SSD1306_SETSTARTLINE | startLineInFlight);
+        startLineInFlight = -1;
+    }
+    frameMicros += micros() - stepStart;
+    // Mirrored here rather than in present() so the serial write stays off
+    // the drawing task as well
+    if (screenMirror != nullptr) screenMirror->sendFrame(frontBuffer, startLine);
+
+    panelValid = true;
+    bytesSent += frameSent;
+    bytesSkipped += BUFFER_SIZE - frameSent;
+    lastFrameMicros = frameMicros;
+    lastFrameBytes = frameSent;
+    flushBusy.store(false, std::memory_order_release);
+    return false;
+}
+
+#ifdef ESP32
+template <class Backend>
+void OLEDDisplay<Backend>::flushTaskMain(void* arg) {
+    OLEDDisplay* self = static_cast<OLEDDisplay*>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->flushSlice(BUFFER_SIZE)) {}
     }
 }
 
-void OLED::drawString(int x, int y, const char* str) {
-    int cursorX = x;
+template <class Backend>
+bool OLEDDisplay<Backend>::startFlushTask(uint8_t core) {
+    if (flushTask != nullptr) return true;
+    // Finish anything the cooperative path had in flight before handing over
+    while (flushSlice(BUFFER_SIZE)) {}
+    return xTaskCreatePinnedToCore(flushTaskMain, "oled_flush", 2048, this, 1,
+                                   &flushTask, core) == pdPASS;
+}
+#endif
+
+template <class Backend>
+void OLEDDisplay<Backend>::drawChar(int x, int y, char c) {
+    char str[2] = { c, '\0' };
+    drawString(x, y, str);
+}
+
+// Glyphs are ORed into displayBuffer a whole column byte at a time. A glyph
+// on a page boundary (y % 8 == 0) touches one byte per column per glyph page;
+// otherwise each column byte is split across the two pages it straddles.
+// Vertical clipping is resolved once for the string and horizontal clipping
+// once per glyph.
+template <class Backend>
+void OLEDDisplay<Backend>::drawString(int x, int y, const char* str) {
+    const OLEDFont& f = *font;
+    if (y <= -(f.pages * 8) || y >= logicalHeight) return;
+
+    // Skip glyphs that lie entirely left of the screen
     while (*str) {
-        drawChar(cursorX, y, *str);
-        cursorX += 6; // 5 pixels wide + 1 pixel spacing
+        const OLEDGlyph& glyph = fontGlyph(f, *str);
+        if (x + glyph.width > 0) break;
+        x += glyph.advance;
         str++;
     }
+
+    int page = (y >= 0) ? (y >> 3) : -((7 - y) >> 3);
+    uint8_t shift = y - page * 8;
+
+    // Destination rows for each glyph page (and the page below it), with the
+    // column span that actually changed on each
+    uint8_t* rows[FONT_MAX_PAGES + 1];
+    int changedMin[FONT_MAX_PAGES + 1];
+    int changedMax[FONT_MAX_PAGES + 1];
+    for (uint8_t p = 0; p <= f.pages; p++) {
+        int dest = page + p;
+        bool used = (p < f.pages) || shift != 0;
+        rows[p] = (used && dest >= 0 && dest < logicalPages) ? &displayBuffer[dest * logicalWidth] : nullptr;
+        changedMin[p] = logicalWidth;
+        changedMax[p] = -1;
+    }
+
+    for (; *str && x < logicalWidth; str++) {
+        const OLEDGlyph& glyph = fontGlyph(f, *str);
+        int first = (x < 0) ? -x : 0;
+        int last = (x + glyph.width > logicalWidth) ? logicalWidth - x : glyph.width;
+
+        for (uint8_t p = 0; p < f.pages; p++) {
+            const uint8_t* columns = f.bitmap + glyph.offset + p * f.stride;
+            uint8_t* lower = rows[p];
+            uint8_t* upper = (shift != 0) ? rows[p + 1] : nullptr;
+            for (int i = first; i < last; i++) {
+                uint8_t line = columns[i];
+                if (line == 0) continue;
+                int col = x + i;
+                if (lower) {
+                    uint8_t value = lower[col] | (uint8_t)(line << shift);
+                    if (value != lower[col]) {
+                        lower[col] = value;
+                        if (col < changedMin[p]) changedMin[p] = col;
+                        if (col > changedMax[p]) changedMax[p] = col;
+                    }
+                }
+                if (upper) {
+                    uint8_t value = upper[col] | (uint8_t)(line >> (8 - shift));
+                    if (value != upper[col]) {
+                        upper[col] = value;
+                        if (col < changedMin[p + 1]) changedMin[p + 1] = col;
+                        if (col > changedMax[p + 1]) changedMax[p + 1] = col;
+                    }
+                }
+            }
+        }
+        x += glyph.advance;
+    }
+
+    for (uint8_t p = 0; p <= f.pages; p++) {
+        if (changedMax[p] >= 0) markDirty(page + p, changedMin[p], changedMax[p]);
+    }
+}
+
+// Each destination byte is built from the two source pages it overlaps,
+// read as one 16-bit word and shifted into place, so a bitmap costs one
+// read-modify-write per covered column per page whatever its alignment.
+// Clipping to the screen and the bitmap height is folded into one row mask
+// per page, computed once.
+template <class Backend>
+void OLEDDisplay<Backend>::drawBitmap(int x, int y, const uint8_t* bitmap, int width, int height,
+                                      OLEDRasterOp rop) {
+    int x0 = max(x, 0);
+    int y0 = max(y, 0);
+    int x1 = min(x + width - 1, logicalWidth - 1);
+    int y1 = min(y + height - 1, logicalHeight - 1);
+    if (x0 > x1 || y0 > y1) return;
+
+    int srcPages = (height + 7) >> 3;
+    int page0 = (y >= 0) ? (y >> 3) : -((7 - y) >> 3);
+    uint8_t shift = y - page0 * 8;
+    int lastPage = y1 >> 3;
+
+    for (int page = y0 >> 3; page <= lastPage; page++) {
+        uint8_t mask = 0xFF;
+        if (page == (y0 >> 3)) mask &= (uint8_t)(0xFF << (y0 & 7));
+        if (page == lastPage) mask &= (uint8_t)(0xFF >> (7 - (y1 & 7)));
+
+        // Source page whose top rows land on this page, and the one above it
+        int k = page - page0;
+        const uint8_t* upper = (k < srcPages) ? &bitmap[k * width] : nullptr;
+        const uint8_t* lower = (k > 0) ? &bitmap[(k - 1) * width] : nullptr;
+
+        uint8_t* row = &displayBuffer[page * logicalWidth];
+        int changedMin = logicalWidth, changedMax = -1;
+        for (int col = x0; col <= x1; col++) {
+            int c = col - x;
+            uint16_t word = ((upper ? upper[c] : 0) << 8) | (lower ? lower[c] : 0);
+            uint8_t bits = (uint8_t)(word >> (8 - shift)) & mask;
+            uint8_t value;
+            switch (rop) {
+                case OLED_ROP_AND:  value = row[col] & (bits | ~mask); break;
+                case OLED_ROP_XOR:  value = row[col] ^ bits; break;
+                case OLED_ROP_COPY: value = (row[col] & ~mask) | bits; break;
+                default:            value = row[col] | bits; break;
+            }
+            if (value != row[col]) {
+                row[col] = value;
+                if (col < changedMin) changedMin = col;
+                changedMax = col;
+            }
+        }
+        if (changedMax >= 0) markDirty(page, changedMin, changedMax);
+    }
 }
 
-void OLED::drawString(int x, int y, String str) {
+template <class Backend>
+void OLEDDisplay<Backend>::drawBitmap(int x, int y, const OLEDBitmap& bitmap, OLEDRasterOp rop) {
+    drawBitmap(x, y, bitmap.data, bitmap.width, bitmap.height, rop);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::setFont(const OLEDFont& newFont) {
+    font = &newFont;
+}
+
+template <class Backend>
+int OLEDDisplay<Backend>::measureString(const char* str) const {
+    return fontTextWidth(*font, str);
+}
+
+template <class Backend>
+void OLEDDisplay<Backend>::drawString(int x, int y, String str) {
     drawString(x, y, str.c_str());
-}
\ No newline at end of file
+}
+
+// Backends available to OLED_BACKEND and to host builds
+template class OLEDDisplay<SSD1306Backend>;
+template class OLEDDisplay<SH1106Backend>;
+template class OLEDDisplay<MemoryBackend>;
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "baro_math.h"
+#include <math.h>
+#include <string.h>
+
+#define LN2_HI      0.693145751953125f      // ln 2 split so k * LN2_HI is exact
+#define LN2_LO      1.42860676533018e-06f
+#define INV_LN2     1.44269504088896f
+#define SQRT2       1.41421356237310f
+
+// Q30 constants for the integer path
+#define Q30_ONE     (1LL << 30)
+#define Q30_LN2     744261118LL
+#define Q30_SQRT2   1518500250LL
+#define Q30_SQRT1_2 759250125LL
+#define Q30_EXPONENT 204327654LL            // 1 / 5.255
+
+float baroLog(float x) {
+    if (x <= 0.0f) return -88.0f;           // Far enough below zero that baroExp() gives 0
+
+    // x = m * 2^e with m in [sqrt(1/2), sqrt(2))
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int32_t e = (int32_t)((bits >> 23) & 0xFF) - 127;
+    bits = (bits & 0x007FFFFF) | 0x3F800000;
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    if (m > SQRT2) {
+        m *= 0.5f;
+        e++;
+    }
+
+    // ln m = 2 atanh(s), s = (m - 1) / (m + 1)
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float series = 1.0f + s2 * (1.0f / 3 + s2 * (1.0f / 5 + s2 * (1.0f / 7 + s2 * (1.0f / 9))));
+    return (float)e * LN2_HI + ((float)e * LN2_LO + 2.0f * s * series);
+}
+
+float baroExp(float x) {
+    if (x < -87.0f) return 0.0f;
+    if (x > 88.0f) x = 88.0f;
+
+    // e^x = 2^k * e^f with |f| <= ln(2) / 2
+    int32_t k = (int32_t)(x * INV_LN2 + (x < 0.0f ? -0.5f : 0.5f));
+    float f = (x - (float)k * LN2_HI) - (float)k * LN2_LO;
+    float p = 1.0f + f * (1.0f + f * (1.0f / 2 + f * (1.0f / 6 + f * (1.0f / 24 +
+              f * (1.0f / 120 + f * (1.0f / 720 + f * (1.0f / 5040)))))));
+
+    uint32_t bits = (uint32_t)(k + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+float baroPow(float x, float y) {
+    return baroExp(y * baroLog(x));
+}
+
+float baroAltitudeFast(float pressurePa, float seaLevelPa) {
+    if (seaLevelPa <= 0.0f) seaLevelPa = 101325.0f;
+    return BARO_SCALE_M * (1.0f - baroPow(pressurePa / seaLevelPa, BARO_EXPONENT));
+}
+
+float baroSeaLevelFast(float pressurePa, float altitudeM) {
+    // p / base^5.255 = p * e^(-5.255 ln base)
+    float base = 1.0f - altitudeM / BARO_SCALE_M;
+    return pressurePa * baroExp(-5.255f * baroLog(base));
+}
+
+#ifdef BARO_MATH_FAST
+#define BARO_POW baroPow
+#else
+#define BARO_POW powf
+#endif
+
+float baroAltitude(float pressurePa, float seaLevelPa) {
+    if (seaLevelPa <= 0.0f) seaLevelPa = 101325.0f;
+    return BARO_SCALE_M * (1.0f - BARO_POW(pressurePa / seaLevelPa, BARO_EXPONENT));
+}
+
+float baroSeaLevel(float pressurePa, float altitudeM) {
+#ifdef BARO_MATH_FAST
+    return baroSeaLevelFast(pressurePa, altitudeM);
+#else
+    return pressurePa / powf(1.0f - altitudeM / BARO_SCALE_M, 5.255f);
+#endif
+}
+
+void baroAltitudeBatch(const float* pressurePa, float* altitudeM, uint16_t count,
+                       float seaLevelPa) {
+    if (seaLevelPa <= 0.0f) seaLevelPa = 101325.0f;
+    const float inverse = 1.0f / seaLevelPa;
+    for (uint16_t i = 0; i < count; i++) {
+        altitudeM[i] = BARO_SCALE_M * (1.0f - BARO_POW(pressurePa[i] * inverse, BARO_EXPONENT));
+    }
+}
+
+int32_t baroAltitudeCm(int32_t pressurePa, int32_t seaLevelPa) {
+    if (seaLevelPa <= 0) seaLevelPa = 101325;
+    if (pressurePa < 0) pressurePa = 0;
+
+    // Pressure ratio in Q30, clamped so the series below stay accurate
+    int64_t r = ((int64_t)pressurePa << 30) / seaLevelPa;
+    if (r < Q30_ONE / 5) r = Q30_ONE / 5;
+    if (r > 2 * Q30_ONE) r = 2 * Q30_ONE;
+
+    // ln r, with the same range reduction as baroLog()
+    int32_t e = 0;
+    while (r > Q30_SQRT2) {
+        r >>= 1;
+        e++;
+    }
+    while (r < Q30_SQRT1_2) {
+        r <<= 1;
+        e--;
+    }
+    int64_t s = ((r - Q30_ONE) << 30) / (r + Q30_ONE);
+    int64_t s2 = (s * s) >> 30;
+    int64_t series = Q30_ONE / 9;
+    series = Q30_ONE / 7 + ((series * s2) >> 30);
+    series = Q30_ONE / 5 + ((series * s2) >> 30);
+    series = Q30_ONE / 3 + ((series * s2) >> 30);
+    series = Q30_ONE + ((series * s2) >> 30);
+    int64_t ln = ((2 * s * series) >> 30) + e * Q30_LN2;
+
+    // 1 - r^(1/5.255) = -expm1(y), |y| <= 0.31 over the clamped range
+    int64_t y = (ln * Q30_EXPONENT) >> 30;
+    int64_t t = Q30_ONE;
+    for (int k = 8; k >= 2; k--) {
+        t = Q30_ONE + ((t * y) >> 30) / k;
+    }
+    int64_t expm1 = (t * y) >> 30;
+    return (int32_t)((-expm1 * 4433000LL + (Q30_ONE >> 1)) >> 30);
+}
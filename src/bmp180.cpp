@@ -1,118 +1,263 @@
 #include "bmp180.h"
 #include <Wire.h>
-#include <math.h>
+#include "baro_math.h"
+#if BMP180_CAL_CACHE
+#include <Preferences.h>
+#endif
 
-BMP180::BMP180() : _wire(nullptr), _oss(BMP180_OSS_ULTRAHIGHRES) {}
+// Pressure conversion times per oversampling setting (datasheet maximum)
+static const uint16_t pressureConversionMicros[4] = { 4500, 7500, 13500, 25500 };
+
+BMP180::BMP180()
+    : _oss(BMP180_OSS_ULTRAHIGHRES), _nextOss(BMP180_OSS_ULTRAHIGHRES),
+      _averaging(1), _avgCount(0), _avgSum(0), _calFromCache(false),
+      _bootTransactions(0), _cycleTransactions(0), _sampleTransactions(0), _conversion(BMP180_CONV_NONE),
+      _convStart(0), _convTime(0), _cycleStarted(false), _cycleStart(0),
+      _tempValid(false), _tempMillis(0), _pressureReads(0), _tempEveryReads(1), _tempMaxAgeMs(0),
+      _B5(0), _B6(0), _B3Base(0), _B4(0) {
+    memset(&_last, 0, sizeof(_last));
+}
 
 bool BMP180::begin(TwoWire* wire, uint8_t oss) {
-    _wire = wire;
-    _oss  = oss;
+    _dev.begin(wire, BMP180_ADDR);
+    _oss  = oss & 3;
+    _nextOss = _oss;
+    _avgCount = 0;
+    _avgSum = 0;
+    _tempValid = false;
+    uint32_t start = _dev.getTransactions();
 
-    if (!isConnected()) {
-        return false;
+    // A chip whose coefficients match the cache is the sensor that filled it
+    bool ok = false;
+    uint8_t block[BMP180_CAL_BYTES];
+    if (loadCachedCalibration(block) && chipMatchesCalibration(block) && parseCalibration(block)) {
+        _calFromCache = true;
+        ok = true;
+    } else {
+        ok = isConnected() && readCalibrationData();
     }
-    return readCalibrationData();
+    _bootTransactions = _dev.getTransactions() - start;
+    return ok;
 }
 
 
 bool BMP180::isConnected() {
-    if (_wire == nullptr) return false;
-    _wire->beginTransmission(BMP180_ADDR);
-    return (_wire->endTransmission() == 0);
+    uint8_t id;
+    return _dev.readRegisters(BMP180_REG_CHIP_ID, &id, 1) && id == BMP180_CHIP_ID;
 }
 
+// All calibration coefficients (datasheet) in one burst read
 bool BMP180::readCalibrationData() {
-    // Read all calibration coefficients as per datasheet
-    ac1 = (int16_t)readRegister16(BMP180_REG_CAL_AC1);
-    ac2 = (int16_t)readRegister16(BMP180_REG_CAL_AC2);
-    ac3 = (int16_t)readRegister16(BMP180_REG_CAL_AC3);
-    ac4 =              readRegister16(BMP180_REG_CAL_AC4);
-    ac5 =              readRegister16(BMP180_REG_CAL_AC5);
-    ac6 =              readRegister16(BMP180_REG_CAL_AC6);
-    b1  = (int16_t)readRegister16(BMP180_REG_CAL_B1);
-    b2  = (int16_t)readRegister16(BMP180_REG_CAL_B2);
-    mb  = (int16_t)readRegister16(BMP180_REG_CAL_MB);
-    mc  = (int16_t)readRegister16(BMP180_REG_CAL_MC);
-    md  = (int16_t)readRegister16(BMP180_REG_CAL_MD);
+    uint8_t block[BMP180_CAL_BYTES];
+    if (!_dev.readRegisters(BMP180_REG_CAL_AC1, block, BMP180_CAL_BYTES)) return false;
+    if (!parseCalibration(block)) return false;
+    storeCachedCalibration(block);
+    _calFromCache = false;
+    return true;
+}
+
+// Field of the calibration block by its register address
+static inline const uint8_t* calField(const uint8_t* block, uint8_t reg) {
+    return block + (reg - BMP180_REG_CAL_AC1);
+}
+
+bool BMP180::parseCalibration(const uint8_t* block) {
+    int16_t newAc1 = be16s(calField(block, BMP180_REG_CAL_AC1));
+    uint16_t newAc4 = be16(calField(block, BMP180_REG_CAL_AC4));
+    uint16_t newAc5 = be16(calField(block, BMP180_REG_CAL_AC5));
 
     // Basic sanity checks (protect against all-zeros or 0xFFFF on unsigned fields)
-    if (ac1 == 0 || ac1 == -1) return false;
-    if (ac4 == 0 || ac4 == 0xFFFF) return false;
-    if (ac5 == 0 || ac5 == 0xFFFF) return false;
+    if (newAc1 == 0 || newAc1 == -1) return false;
+    if (newAc4 == 0 || newAc4 == 0xFFFF) return false;
+    if (newAc5 == 0 || newAc5 == 0xFFFF) return false;
 
+    ac1 = newAc1;
+    ac2 = be16s(calField(block, BMP180_REG_CAL_AC2));
+    ac3 = be16s(calField(block, BMP180_REG_CAL_AC3));
+    ac4 = newAc4;
+    ac5 = newAc5;
+    ac6 = be16(calField(block, BMP180_REG_CAL_AC6));
+    b1  = be16s(calField(block, BMP180_REG_CAL_B1));
+    b2  = be16s(calField(block, BMP180_REG_CAL_B2));
+    mb  = be16s(calField(block, BMP180_REG_CAL_MB));
+    mc  = be16s(calField(block, BMP180_REG_CAL_MC));
+    md  = be16s(calField(block, BMP180_REG_CAL_MD));
+    _tempValid = false;
     return true;
 }
 
-void BMP180::writeRegister(uint8_t reg, uint8_t value) {
-    _wire->beginTransmission(BMP180_ADDR);
-    _wire->write(reg);
-    _wire->write(value);
-    _wire->endTransmission();
+// Factory coefficients differ from part to part, so the first three tell the
+// cached sensor from a swapped one in a single 6-byte read
+bool BMP180::chipMatchesCalibration(const uint8_t* block) {
+    uint8_t head[BMP180_CAL_CHECK_BYTES];
+    return _dev.readRegisters(BMP180_REG_CAL_AC1, head, BMP180_CAL_CHECK_BYTES) &&
+           memcmp(head, block, BMP180_CAL_CHECK_BYTES) == 0;
 }
 
-uint8_t BMP180::readRegister8(uint8_t reg) {
-    _wire->beginTransmission(BMP180_ADDR);
-    _wire->write(reg);
-    _wire->endTransmission();
-    _wire->requestFrom(BMP180_ADDR, (uint8_t)1);
-    if (_wire->available() < 1) return 0;
-    return _wire->read();
+#if BMP180_CAL_CACHE
+// One entry per I2C address, e.g. "cal77"; begin() checks it against the chip
+static void calibrationKey(char* key, uint8_t address) {
+    snprintf(key, 12, "cal%02x", address);
 }
 
-uint16_t BMP180::readRegister16(uint8_t reg) {
-    _wire->beginTransmission(BMP180_ADDR);
-    _wire->write(reg);
-    _wire->endTransmission();
-    _wire->requestFrom(BMP180_ADDR, (uint8_t)2);
-    if (_wire->available() < 2) return 0;
-    uint16_t hi = _wire->read();
-    uint16_t lo = _wire->read();
-    return (hi << 8) | lo;
+bool BMP180::loadCachedCalibration(uint8_t* block) {
+    char key[12];
+    calibrationKey(key, _dev.getAddress());
+    Preferences prefs;
+    if (!prefs.begin("bmp180", true)) return false;
+    bool ok = prefs.getBytesLength(key) == BMP180_CAL_BYTES &&
+              prefs.getBytes(key, block, BMP180_CAL_BYTES) == BMP180_CAL_BYTES;
+    prefs.end();
+    return ok;
 }
 
-int32_t BMP180::readRawTemperature() {
-    // Start temperature conversion
-    writeRegister(BMP180_REG_CONTROL, BMP180_CMD_TEMP);
-    // Wait 4.5 ms minimum
-    delay(5);
-    // Read uncompensated temperature
-    return (int32_t)readRegister16(BMP180_REG_RESULT);
+void BMP180::storeCachedCalibration(const uint8_t* block) {
+    char key[12];
+    calibrationKey(key, _dev.getAddress());
+    Preferences prefs;
+    if (!prefs.begin("bmp180", false)) return;
+    prefs.putBytes(key, block, BMP180_CAL_BYTES);
+    prefs.end();
 }
 
-int32_t BMP180::readRawPressure() {
-    uint8_t cmd;
-    uint8_t delay_time;
+void BMP180::clearCalibrationCache() {
+    char key[12];
+    calibrationKey(key, _dev.getAddress());
+    Preferences prefs;
+    if (!prefs.begin("bmp180", false)) return;
+    prefs.remove(key);
+    prefs.end();
+}
+#else
+bool BMP180::loadCachedCalibration(uint8_t*) { return false; }
+void BMP180::storeCachedCalibration(const uint8_t*) {}
+void BMP180::clearCalibrationCache() {}
+#endif
+
+bool BMP180::startTemperature() {
+    if (!_dev.isAttached()) return false;
+    _dev.writeRegister(BMP180_REG_CONTROL, BMP180_CMD_TEMP);
+    _conversion = BMP180_CONV_TEMPERATURE;
+    _convStart = micros();
+    _convTime = BMP180_TEMP_CONVERSION_US;
+    return true;
+}
+
+void BMP180::setOversampling(uint8_t oss) {
+    _nextOss = oss & 3;
+}
+
+void BMP180::setAveraging(uint8_t samples) {
+    if (samples < 1) samples = 1;
+    if (samples > 16) samples = 16;
+    _averaging = samples;
+}
+
+uint32_t BMP180::pressureConversionTime(uint8_t oss) {
+    return pressureConversionMicros[oss & 3];
+}
 
+bool BMP180::startPressure() {
+    if (!_dev.isAttached()) return false;
+    _oss = _nextOss;
+    uint8_t cmd;
     switch (_oss) {
-        case BMP180_OSS_ULTRALOWPOWER: cmd = BMP180_CMD_PRESS0; delay_time = 5;  break;
-        case BMP180_OSS_STANDARD:      cmd = BMP180_CMD_PRESS1; delay_time = 8;  break;
-        case BMP180_OSS_HIGHRES:       cmd = BMP180_CMD_PRESS2; delay_time = 14; break;
+        case BMP180_OSS_ULTRALOWPOWER: cmd = BMP180_CMD_PRESS0; break;
+        case BMP180_OSS_STANDARD:      cmd = BMP180_CMD_PRESS1; break;
+        case BMP180_OSS_HIGHRES:       cmd = BMP180_CMD_PRESS2; break;
         case BMP180_OSS_ULTRAHIGHRES:
-        default:                       cmd = BMP180_CMD_PRESS3; delay_time = 26; break;
+        default:                       cmd = BMP180_CMD_PRESS3; break;
+    }
+    _dev.writeRegister(BMP180_REG_CONTROL, cmd);
+    _conversion = BMP180_CONV_PRESSURE;
+    _convStart = micros();
+    _convTime = pressureConversionMicros[_oss & 3];
+    return true;
+}
+
+bool BMP180::conversionReady() const {
+    return _conversion != BMP180_CONV_NONE && (uint32_t)(micros() - _convStart) >= _convTime;
+}
+
+void BMP180::waitForConversion() {
+    // Blocking reads abandon a tick() average in progress
+    _avgCount = 0;
+    _avgSum = 0;
+    uint32_t elapsed = micros() - _convStart;
+    if (elapsed < _convTime) {
+        delay((_convTime - elapsed + 999) / 1000);
     }
+}
+
+int32_t BMP180::fetchRawTemperature() {
+    _conversion = BMP180_CONV_NONE;
+    uint8_t data[2];
+    if (!_dev.readRegisters(BMP180_REG_RESULT, data, 2)) return 0;
+    return (int32_t)be16(data);
+}
 
-    // Start pressure conversion
-    writeRegister(BMP180_REG_CONTROL, cmd);
-    delay(delay_time);
+int32_t BMP180::fetchRawPressure() {
+    _conversion = BMP180_CONV_NONE;
+    if (_pressureReads != 0xFFFF) _pressureReads++;
 
     // Read 3 bytes (MSB, LSB, XLSB)
-    _wire->beginTransmission(BMP180_ADDR);
-    _wire->write(BMP180_REG_RESULT);
-    _wire->endTransmission();
-    _wire->requestFrom(BMP180_ADDR, (uint8_t)3);
-    if (_wire->available() < 3) return 0;
-
-    uint32_t raw = 0;
-    raw  = (uint32_t)_wire->read(); // MSB
-    raw <<= 8;
-    raw |= (uint32_t)_wire->read(); // LSB
-    raw <<= 8;
-    raw |= (uint32_t)_wire->read(); // XLSB
-
-    raw >>= (8 - _oss);
+    uint8_t data[3];
+    if (!_dev.readRegisters(BMP180_REG_RESULT, data, 3)) return 0;
+    uint32_t raw = be24(data) >> (8 - _oss);
     return (int32_t)raw;
 }
 
+int32_t BMP180::readRawTemperature() {
+    startTemperature();
+    waitForConversion();
+    return fetchRawTemperature();
+}
+
+int32_t BMP180::readRawPressure() {
+    startPressure();
+    waitForConversion();
+    return fetchRawPressure();
+}
+
+bool BMP180::tick(uint32_t intervalMs) {
+    if (!_dev.isAttached()) return false;
+
+    switch (_conversion) {
+        case BMP180_CONV_NONE:
+            if (_cycleStarted && millis() - _cycleStart < intervalMs) return false;
+            _cycleStarted = true;
+            _cycleStart = millis();
+            _cycleTransactions = _dev.getTransactions();
+            if (temperatureDue()) {
+                startTemperature();
+            } else {
+                startPressure();
+            }
+            return false;
+
+        case BMP180_CONV_TEMPERATURE:
+            if (!conversionReady()) return false;
+            updateTemperature(fetchRawTemperature());
+            startPressure();
+            return false;
+
+        case BMP180_CONV_PRESSURE:
+        default:
+            if (!conversionReady()) return false;
+            _avgSum += compensatePressure(fetchRawPressure());
+            _avgCount++;
+            if (_avgCount < _averaging) {
+                startPressure();
+                return false;
+            }
+            _last = makeSample((_avgSum + _avgCount / 2) / _avgCount, _avgCount);
+            _sampleTransactions = _dev.getTransactions() - _cycleTransactions;
+            _avgSum = 0;
+            _avgCount = 0;
+            return true;
+    }
+}
+
 int32_t BMP180::computeB5(int32_t UT) {
     // B5 = X1 + X2, where:
     // X1 = (UT - AC6) * AC5 / 2^15
@@ -122,53 +267,116 @@ int32_t BMP180::computeB5(int32_t UT) {
     return X1 + X2;
 }
 
+void BMP180::setTemperatureRefresh(uint16_t everyReads, uint32_t maxAgeMs) {
+    _tempEveryReads = everyReads;
+    _tempMaxAgeMs = maxAgeMs;
+}
+
+bool BMP180::temperatureDue() const {
+    if (!_tempValid) return true;
+    if (_tempEveryReads != 0 && _pressureReads >= _tempEveryReads) return true;
+    if (_tempMaxAgeMs != 0 && millis() - _tempMillis >= _tempMaxAgeMs) return true;
+    return false;
+}
+
+// Cache B5 and the temperature-only pressure terms (datasheet)
+void BMP180::updateTemperature(int32_t UT) {
+    _B5 = computeB5(UT);
+    _B6 = _B5 - 4000;
+    int32_t X1 = ((int32_t)b2 * ((_B6 * _B6) >> 12)) >> 11;
+    int32_t X2 = ((int32_t)ac2 * _B6) >> 11;
+    _B3Base = ((int32_t)ac1) * 4 + X1 + X2;
+    X1 = ((int32_t)ac3 * _B6) >> 13;
+    X2 = ((int32_t)b1  * ((_B6 * _B6) >> 12)) >> 16;
+    int32_t X3 = ((X1 + X2) + 2) >> 2;
+    _B4 = ((uint32_t)ac4 * (uint32_t)(X3 + 32768)) >> 15;
+    _tempValid = true;
+    _tempMillis = millis();
+    _pressureReads = 0;
+}
+
 float BMP180::readTemperature() {
-    int32_t UT = readRawTemperature();
-    int32_t B5 = computeB5(UT);
+    updateTemperature(readRawTemperature());
     // T in 0.1 °C: T = (B5 + 8) / 2^4
-    int32_t T = (B5 + 8) >> 4;
+    int32_t T = (_B5 + 8) >> 4;
     return T / 10.0f;
 }
 
+BMP180Sample BMP180::makeSample(int32_t pressure, uint8_t averaged) {
+    BMP180Sample sample;
+    sample.valid = true;
+    sample.temperature = ((_B5 + 8) >> 4) / 10.0f;
+    sample.pressure = (float)pressure;
+    sample.oss = _oss;
+    sample.averaged = averaged;
+    sample.timestamp = millis();
+    sample.altitudeCount = 0;
+    return sample;
+}
+
+BMP180Sample BMP180::sample(const float* seaLevelPressures, uint8_t count) {
+    if (!_dev.isAttached()) {
+        BMP180Sample empty;
+        memset(&empty, 0, sizeof(empty));
+        return empty;
+    }
+    if (temperatureDue()) updateTemperature(readRawTemperature());
+    BMP180Sample result = makeSample(compensatePressure(readRawPressure()), 1);
+    computeAltitudes(result, seaLevelPressures, count);
+    return result;
+}
+
+BMP180Sample BMP180::lastSample(const float* seaLevelPressures, uint8_t count) const {
+    BMP180Sample result = _last;
+    if (result.valid) computeAltitudes(result, seaLevelPressures, count);
+    return result;
+}
+
+void BMP180::computeAltitudes(BMP180Sample& sample, const float* seaLevelPressures, uint8_t count) {
+    if (seaLevelPressures == nullptr) count = 0;
+    if (count > BMP180_MAX_ALTITUDES) count = BMP180_MAX_ALTITUDES;
+    for (uint8_t i = 0; i < count; i++) {
+        sample.altitude[i] = baroAltitude(sample.pressure, seaLevelPressures[i]);
+    }
+    sample.altitudeCount = count;
+}
+
 float BMP180::readPressure() {
-    int32_t UT = readRawTemperature();
-    int32_t UP = readRawPressure();
-    // True pressure calculation (datasheet)
-    int32_t B5 = computeB5(UT);
-    int32_t B6 = B5 - 4000;
-    int32_t X1 = ((int32_t)b2 * ((B6 * B6) >> 12)) >> 11;
-    int32_t X2 = ((int32_t)ac2 * B6) >> 11;
-    int32_t X3 = X1 + X2;
+    if (temperatureDue()) updateTemperature(readRawTemperature());
+    return (float)compensatePressure(readRawPressure()); // Pascals
+}
+
+// True pressure calculation (datasheet), from the cached temperature terms
+int32_t BMP180::compensatePressure(int32_t UP) const {
     // Correct rounding per datasheet:
     // B3 = (((AC1*4 + X3) << OSS) + 2) / 4
-    int32_t B3 = (((((int32_t)ac1) * 4 + X3) << _oss) + 2) >> 2;
-    X1 = ((int32_t)ac3 * B6) >> 13;
-    X2 = ((int32_t)b1  * ((B6 * B6) >> 12)) >> 16;
-    X3 = ((X1 + X2) + 2) >> 2;
-    uint32_t B4 = ((uint32_t)ac4 * (uint32_t)(X3 + 32768)) >> 15;
+    int32_t B3 = ((_B3Base << _oss) + 2) >> 2;
     uint32_t B7 = ((uint32_t)UP - (uint32_t)B3) * (uint32_t)(50000UL >> _oss);
     int32_t p;
     if (B7 < 0x80000000UL) {
         // p = (B7 * 2) / B4
-        p = (int32_t)((B7 << 1) / B4);
+        p = (int32_t)((B7 << 1) / _B4);
     } else {
         // p = (B7 / B4) * 2
-        p = (int32_t)((B7 / B4) << 1);
+        p = (int32_t)((B7 / _B4) << 1);
     }
-    X1 = (p >> 8);
+    int32_t X1 = (p >> 8);
     X1 = (X1 * X1);
     X1 = (X1 * 3038) >> 16;
-    X2 = (-7357 * p) >> 16;
+    int32_t X2 = (-7357 * p) >> 16;
     p = p + ((X1 + X2 + (int32_t)3791) >> 4);
-    return (float)p; // Pascals
+    return p;
 }
 
 float BMP180::readAltitude(float seaLevelPressure /* Pa */) {
     // Protect against bad input
     if (seaLevelPressure <= 0.0f) seaLevelPressure = 101325.0f;
-    const float pressure = readPressure(); // Pa
-    // Standard barometric formula: 0.190294957 ≈ 1/5.255
-    return 44330.0f * (1.0f - powf(pressure / seaLevelPressure, 0.190294957f));
+    return pressureToAltitude(readPressure(), seaLevelPressure);
+}
+
+float BMP180::pressureToAltitude(float pressurePa, float seaLevelPressure /* Pa */) {
+    // Standard barometric formula, see baro_math.h
+    return baroAltitude(pressurePa, seaLevelPressure);
 }
 
 int32_t BMP180::getRawTemperature() {
@@ -0,0 +1,95 @@
+#include "bmp180_oss_policy.h"
+#include <math.h>
+
+static const float noisePa[4] = BMP180_NOISE_PA;
+
+BMP180OssPolicy::BMP180OssPolicy(float budgetMs, float noiseTargetPa)
+    : _budgetMs(budgetMs), _noiseTargetPa(noiseTargetPa), _threshold(0.3f), _holdMs(3000),
+      _moving(false), _stillSince(0) {
+    memset(_samplesAt, 0, sizeof(_samplesAt));
+    _choice.oss = BMP180_OSS_ULTRAHIGHRES;
+    _choice.samples = 1;
+    _choice.timeMs = conversionMs(_choice.oss);
+    _choice.noisePa = noisePa[_choice.oss];
+    _choice.moving = false;
+}
+
+void BMP180OssPolicy::setMotion(float thresholdMps, uint32_t holdMs) {
+    _threshold = thresholdMps;
+    _holdMs = holdMs;
+}
+
+float BMP180OssPolicy::conversionMs(uint8_t oss) {
+    return BMP180::pressureConversionTime(oss) / 1000.0f + BMP180_CONVERSION_OVERHEAD_MS;
+}
+
+BMP180OssChoice BMP180OssPolicy::choose(float verticalSpeed, uint32_t nowMs) {
+    float speed = fabsf(verticalSpeed);
+    if (speed > _threshold) {
+        _moving = true;
+        _stillSince = nowMs;
+    } else if (_moving) {
+        if (speed >= _threshold / 2) {
+            _stillSince = nowMs;
+        } else if (nowMs - _stillSince >= _holdMs) {
+            _moving = false;
+        }
+    }
+
+    BMP180OssChoice best;
+    best.oss = BMP180_OSS_ULTRALOWPOWER;
+    best.samples = 1;
+    best.timeMs = conversionMs(best.oss);
+    best.noisePa = noisePa[best.oss];
+    best.moving = _moving;
+
+    if (_moving) {
+        // One conversion with the most information per ms
+        float bestDensity = best.noisePa * sqrtf(best.timeMs);
+        for (uint8_t oss = 1; oss < 4; oss++) {
+            float time = conversionMs(oss);
+            if (time > _budgetMs) break;
+            float density = noisePa[oss] * sqrtf(time);
+            if (density < bestDensity) {
+                bestDensity = density;
+                best.oss = oss;
+                best.timeMs = time;
+                best.noisePa = noisePa[oss];
+            }
+        }
+    } else {
+        bool met = best.noisePa <= _noiseTargetPa;
+        for (int oss = 3; oss >= 0; oss--) {
+            float time = conversionMs(oss);
+            for (uint8_t n = 1; n <= 16 && n * time <= _budgetMs; n++) {
+                float noise = noisePa[oss] / sqrtf(n);
+                bool meets = noise <= _noiseTargetPa;
+                bool better;
+                if (meets != met) {
+                    better = meets;
+                } else if (meets) {
+                    better = n < best.samples || (n == best.samples && n * time < best.timeMs);
+                } else {
+                    better = noise < best.noisePa;
+                }
+                if (better) {
+                    best.oss = oss;
+                    best.samples = n;
+                    best.timeMs = n * time;
+                    best.noisePa = noise;
+                    met = meets;
+                }
+                if (meets) break;   // More conversions at this OSS only cost more
+            }
+        }
+    }
+
+    _choice = best;
+    _samplesAt[best.oss]++;
+    return best;
+}
+
+void BMP180OssPolicy::apply(BMP180& sensor, const BMP180OssChoice& choice) const {
+    sensor.setOversampling(choice.oss);
+    sensor.setAveraging(choice.samples);
+}
@@ -0,0 +1,74 @@
+#include "dashboard.h"
+#include <stdarg.h>
+
+template <class Display>
+BasicDashboard<Display>::BasicDashboard(Display& display)
+    : _display(display), labelCount(0), fieldCount(0) {
+    memset(baseLayer, 0, BUFFER_SIZE);
+}
+
+template <class Display>
+bool BasicDashboard<Display>::addLabel(int x, int y, const char* text) {
+    if (labelCount >= DASHBOARD_MAX_LABELS) return false;
+    labels[labelCount++] = { (int16_t)x, (int16_t)y, text };
+    return true;
+}
+
+template <class Display>
+int BasicDashboard<Display>::addField(int x, int y, uint8_t maxChars, const OLEDFont& font) {
+    if (fieldCount >= DASHBOARD_MAX_FIELDS) return -1;
+    if (maxChars > DASHBOARD_MAX_CHARS) maxChars = DASHBOARD_MAX_CHARS;
+    Field& field = fields[fieldCount];
+    field.x = x;
+    field.y = y;
+    field.maxChars = maxChars;
+    field.font = &font;
+    field.text[0] = '\0';
+    return fieldCount++;
+}
+
+template <class Display>
+void BasicDashboard<Display>::begin() {
+    _display.clearDisplay();
+    for (uint8_t i = 0; i < labelCount; i++) {
+        _display.drawString(labels[i].x, labels[i].y, labels[i].text);
+    }
+    _display.saveLayer(baseLayer);
+    for (uint8_t i = 0; i < fieldCount; i++) {
+        fields[i].text[0] = '\0';
+    }
+}
+
+template <class Display>
+bool BasicDashboard<Display>::setField(int id, const char* text) {
+    if (id < 0 || id >= fieldCount) return false;
+    Field& field = fields[id];
+    if (strncmp(field.text, text, field.maxChars) == 0) return false;
+
+    // Erase exactly what the old text covered, whatever the field's font
+    const OLEDFont& font = *field.font;
+    _display.restoreRect(baseLayer, field.x, field.y, fontTextWidth(font, field.text), font.pages * 8);
+    strncpy(field.text, text, field.maxChars);
+    field.text[field.maxChars] = '\0';
+
+    const OLEDFont& previous = _display.getFont();
+    _display.setFont(font);
+    _display.drawString(field.x, field.y, field.text);
+    _display.setFont(previous);
+    return true;
+}
+
+template <class Display>
+bool BasicDashboard<Display>::setFieldf(int id, const char* format, ...) {
+    char text[DASHBOARD_MAX_CHARS + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return setField(id, text);
+}
+
+// Display types available to host builds and OLED_BACKEND
+template class BasicDashboard<OLEDDisplay<SSD1306Backend>>;
+template class BasicDashboard<OLEDDisplay<SH1106Backend>>;
+template class BasicDashboard<OLEDDisplay<MemoryBackend>>;
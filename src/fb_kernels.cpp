@@ -0,0 +1,315 @@
+#include "fb_kernels.h"
+#include <string.h>
+
+// Vector path for this target; -DFB_KERNELS_SCALAR leaves it out
+#if !defined(FB_KERNELS_SCALAR) && defined(__SSE2__)
+#define FB_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// Reference byte loops, also the fallback for short or misaligned spans
+static void refInvert(uint8_t* dst, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) dst[i] = ~dst[i];
+}
+
+static void refOr(uint8_t* dst, const uint8_t* src, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) dst[i] |= src[i];
+}
+
+static void refAnd(uint8_t* dst, const uint8_t* src, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) dst[i] &= src[i];
+}
+
+static void refXor(uint8_t* dst, const uint8_t* src, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) dst[i] ^= src[i];
+}
+
+static void refMaskedCopy(uint8_t* dst, const uint8_t* src, uint8_t mask, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) dst[i] = (dst[i] & ~mask) | (src[i] & mask);
+}
+
+static bool refDiffSpan(const uint8_t* a, const uint8_t* b, uint8_t mask, uint16_t count,
+                        uint16_t* first, uint16_t* last) {
+    uint16_t i = 0;
+    while (i < count && ((a[i] ^ b[i]) & mask) == 0) i++;
+    if (i == count) return false;
+    uint16_t j = count - 1;
+    while (((a[j] ^ b[j]) & mask) == 0) j--;
+    *first = i;
+    *last = j;
+    return true;
+}
+
+static bool refNonZeroSpan(const uint8_t* data, uint16_t count, uint16_t* first, uint16_t* last) {
+    uint16_t i = 0;
+    while (i < count && data[i] == 0) i++;
+    if (i == count) return false;
+    uint16_t j = count - 1;
+    while (data[j] == 0) j--;
+    *first = i;
+    *last = j;
+    return true;
+}
+
+#ifdef FB_KERNELS_SSE2
+#define FB_KERNELS_SIMD
+
+// 16-byte block operations on aligned pointers
+static inline void blockInvert(uint8_t* dst) {
+    __m128i* p = (__m128i*)dst;
+    _mm_store_si128(p, _mm_xor_si128(_mm_load_si128(p), _mm_set1_epi8((char)0xFF)));
+}
+
+static inline void blockOr(uint8_t* dst, const uint8_t* src) {
+    __m128i* p = (__m128i*)dst;
+    _mm_store_si128(p, _mm_or_si128(_mm_load_si128(p), _mm_load_si128((const __m128i*)src)));
+}
+
+static inline void blockAnd(uint8_t* dst, const uint8_t* src) {
+    __m128i* p = (__m128i*)dst;
+    _mm_store_si128(p, _mm_and_si128(_mm_load_si128(p), _mm_load_si128((const __m128i*)src)));
+}
+
+static inline void blockXor(uint8_t* dst, const uint8_t* src) {
+    __m128i* p = (__m128i*)dst;
+    _mm_store_si128(p, _mm_xor_si128(_mm_load_si128(p), _mm_load_si128((const __m128i*)src)));
+}
+
+static inline void blockMaskedCopy(uint8_t* dst, const uint8_t* src, uint8_t mask) {
+    __m128i* p = (__m128i*)dst;
+    __m128i d = _mm_load_si128(p);
+    __m128i delta = _mm_xor_si128(d, _mm_load_si128((const __m128i*)src));
+    _mm_store_si128(p, _mm_xor_si128(d, _mm_and_si128(delta, _mm_set1_epi8((char)mask))));
+}
+
+static inline bool blockDiff(const uint8_t* a, const uint8_t* b, uint8_t mask) {
+    __m128i delta = _mm_xor_si128(_mm_load_si128((const __m128i*)a), _mm_load_si128((const __m128i*)b));
+    delta = _mm_and_si128(delta, _mm_set1_epi8((char)mask));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(delta, _mm_setzero_si128())) != 0xFFFF;
+}
+
+static inline bool blockNonZero(const uint8_t* data) {
+    __m128i v = _mm_load_si128((const __m128i*)data);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF;
+}
+
+// Bytes before the first 16-byte boundary at p, capped at count
+static inline uint16_t headBytes(const void* p, uint16_t count) {
+    uint16_t n = (16 - ((uintptr_t)p & 15)) & 15;
+    return (n < count) ? n : count;
+}
+
+static inline bool sameAlignment(const void* a, const void* b) {
+    return (((uintptr_t)a ^ (uintptr_t)b) & 15) == 0;
+}
+
+static void simdInvert(uint8_t* dst, uint16_t count) {
+    uint16_t head = headBytes(dst, count);
+    refInvert(dst, head);
+    dst += head;
+    count -= head;
+    for (; count >= 16; dst += 16, count -= 16) blockInvert(dst);
+    refInvert(dst, count);
+}
+
+// Scalar head up to the alignment boundary, vector body, scalar tail
+template <void (*Block)(uint8_t*, const uint8_t*), void (*Ref)(uint8_t*, const uint8_t*, uint16_t)>
+static void simdBinary(uint8_t* dst, const uint8_t* src, uint16_t count) {
+    if (!sameAlignment(dst, src)) {
+        Ref(dst, src, count);
+        return;
+    }
+    uint16_t head = headBytes(dst, count);
+    Ref(dst, src, head);
+    dst += head;
+    src += head;
+    count -= head;
+    for (; count >= 16; dst += 16, src += 16, count -= 16) Block(dst, src);
+    Ref(dst, src, count);
+}
+
+static void simdMaskedCopy(uint8_t* dst, const uint8_t* src, uint8_t mask, uint16_t count) {
+    if (!sameAlignment(dst, src)) {
+        refMaskedCopy(dst, src, mask, count);
+        return;
+    }
+    uint16_t head = headBytes(dst, count);
+    refMaskedCopy(dst, src, mask, head);
+    dst += head;
+    src += head;
+    count -= head;
+    for (; count >= 16; dst += 16, src += 16, count -= 16) blockMaskedCopy(dst, src, mask);
+    refMaskedCopy(dst, src, mask, count);
+}
+
+// Span search shared by the diff and non-zero kernels. Whole blocks are
+// tested with one vector compare; only the block holding the first (or
+// last) hit is scanned byte by byte.
+struct DiffProbe {
+    const uint8_t* a;
+    const uint8_t* b;
+    uint8_t mask;
+    bool byte(uint16_t i) const { return ((a[i] ^ b[i]) & mask) != 0; }
+    bool block(uint16_t i) const { return blockDiff(a + i, b + i, mask); }
+};
+
+struct NonZeroProbe {
+    const uint8_t* data;
+    bool byte(uint16_t i) const { return data[i] != 0; }
+    bool block(uint16_t i) const { return blockNonZero(data + i); }
+};
+
+template <class Probe>
+static bool simdSpan(const Probe& probe, uint16_t head, uint16_t count, uint16_t* first, uint16_t* last) {
+    uint16_t i = 0;
+    while (i < head && !probe.byte(i)) i++;
+    if (i == head) {
+        while (count - i >= 16 && !probe.block(i)) i += 16;
+        while (i < count && !probe.byte(i)) i++;
+        if (i == count) return false;
+    }
+
+    // Everything from tailStart on is past the last full block
+    uint16_t tailStart = count - ((count - head) & 15);
+    uint16_t j = count;
+    while (j > tailStart && !probe.byte(j - 1)) j--;
+    if (j == tailStart) {
+        while (j >= head + 16 && !probe.block(j - 16)) j -= 16;
+        while (!probe.byte(j - 1)) j--;
+    }
+    *first = i;
+    *last = j - 1;
+    return true;
+}
+
+static bool simdDiffSpan(const uint8_t* a, const uint8_t* b, uint8_t mask, uint16_t count,
+                         uint16_t* first, uint16_t* last) {
+    if (!sameAlignment(a, b)) return refDiffSpan(a, b, mask, count, first, last);
+    DiffProbe probe = { a, b, mask };
+    return simdSpan(probe, headBytes(a, count), count, first, last);
+}
+
+static bool simdNonZeroSpan(const uint8_t* data, uint16_t count, uint16_t* first, uint16_t* last) {
+    NonZeroProbe probe = { data };
+    return simdSpan(probe, headBytes(data, count), count, first, last);
+}
+#endif
+
+static bool simdEnabled = false;
+
+const char* fbKernelsBackend() {
+#ifdef FB_KERNELS_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+void fbKernelsUseSimd(bool enable) {
+#ifdef FB_KERNELS_SIMD
+    simdEnabled = enable;
+#else
+    (void)enable;
+#endif
+}
+
+bool fbKernelsSimdEnabled() {
+    return simdEnabled;
+}
+
+bool fbKernelsInit() {
+    fbKernelsUseSimd(fbKernelsSelfCheck());
+    return simdEnabled;
+}
+
+void fbInvert(uint8_t* dst, uint16_t count) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdInvert(dst, count);
+#endif
+    refInvert(dst, count);
+}
+
+void fbOr(uint8_t* dst, const uint8_t* src, uint16_t count) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdBinary<blockOr, refOr>(dst, src, count);
+#endif
+    refOr(dst, src, count);
+}
+
+void fbAnd(uint8_t* dst, const uint8_t* src, uint16_t count) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdBinary<blockAnd, refAnd>(dst, src, count);
+#endif
+    refAnd(dst, src, count);
+}
+
+void fbXor(uint8_t* dst, const uint8_t* src, uint16_t count) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdBinary<blockXor, refXor>(dst, src, count);
+#endif
+    refXor(dst, src, count);
+}
+
+void fbMaskedCopy(uint8_t* dst, const uint8_t* src, uint8_t mask, uint16_t count) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdMaskedCopy(dst, src, mask, count);
+#endif
+    refMaskedCopy(dst, src, mask, count);
+}
+
+bool fbDiffSpan(const uint8_t* a, const uint8_t* b, uint8_t mask, uint16_t count,
+                uint16_t* first, uint16_t* last) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdDiffSpan(a, b, mask, count, first, last);
+#endif
+    return refDiffSpan(a, b, mask, count, first, last);
+}
+
+bool fbNonZeroSpan(const uint8_t* data, uint16_t count, uint16_t* first, uint16_t* last) {
+#ifdef FB_KERNELS_SIMD
+    if (simdEnabled) return simdNonZeroSpan(data, count, first, last);
+#endif
+    return refNonZeroSpan(data, count, first, last);
+}
+
+// Runs every kernel on both paths over all alignments and lengths up to a
+// few blocks, with sparse random data so spans start and end mid-block
+bool fbKernelsSelfCheck() {
+#ifdef FB_KERNELS_SIMD
+    alignas(16) uint8_t src[96];
+    alignas(16) uint8_t want[96];
+    alignas(16) uint8_t got[96];
+    uint32_t seed = 0x1234567;
+    for (uint16_t offset = 0; offset < 16; offset++) {
+        for (uint16_t count = 0; count <= 64; count++) {
+            for (uint8_t i = 0; i < sizeof(src); i++) {
+                seed = seed * 1103515245 + 12345;
+                src[i] = ((seed >> 28) == 0) ? (seed >> 16) | 1 : 0;
+                got[i] = want[i] = seed >> 8;
+            }
+            uint8_t* w = want + offset;
+            uint8_t* g = got + offset;
+            const uint8_t* s = src + offset;
+            uint8_t mask = seed >> 20;
+
+            refInvert(w, count);              simdInvert(g, count);
+            refOr(w, s, count);               simdBinary<blockOr, refOr>(g, s, count);
+            refXor(w, s, count);              simdBinary<blockXor, refXor>(g, s, count);
+            refMaskedCopy(w, s, mask, count); simdMaskedCopy(g, s, mask, count);
+            refAnd(w, s, count);              simdBinary<blockAnd, refAnd>(g, s, count);
+            if (memcmp(want, got, sizeof(want)) != 0) return false;
+
+            // got now equals want; sparse src bits make the spans vary
+            fbXor(g, s, count);
+            uint16_t f1 = 0, l1 = 0, f2 = 0, l2 = 0;
+            if (refDiffSpan(w, g, mask, count, &f1, &l1) != simdDiffSpan(w, g, mask, count, &f2, &l2) ||
+                f1 != f2 || l1 != l2) return false;
+            if (refNonZeroSpan(s, count, &f1, &l1) != simdNonZeroSpan(s, count, &f2, &l2) ||
+                f1 != f2 || l1 != l2) return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,217 @@
+#include "fonts.h"
+
+// Standard 5x7 font (ASCII 32-126 plus two arrows), one byte per column
+constexpr uint8_t font5x7[97][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // (space)
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // "
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // %
+    {0x36, 0x49, 0x55, 0x22, 0x50}, // &
+    {0x00, 0x05, 0x03, 0x00, 0x00}, // '
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08}, // *
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
+    {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+    {0x00, 0x60, 0x60, 0x00, 0x00}, // .
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // /
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+    {0x00, 0x36, 0x36, 0x00, 0x00}, // :
+    {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
+    {0x00, 0x08, 0x14, 0x22, 0x41}, // <
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // =
+    {0x41, 0x22, 0x14, 0x08, 0x00}, // >
+    {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
+    {0x7F, 0x09, 0x09, 0x01, 0x01}, // F
+    {0x3E, 0x41, 0x41, 0x51, 0x32}, // G
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
+    {0x7F, 0x02, 0x04, 0x02, 0x7F}, // M
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
+    {0x46, 0x49, 0x49, 0x49, 0x31}, // S
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
+    {0x7F, 0x20, 0x18, 0x20, 0x7F}, // W
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // X
+    {0x03, 0x04, 0x78, 0x04, 0x03}, // Y
+    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
+    {0x00, 0x00, 0x7F, 0x41, 0x41}, // [
+    {0x02, 0x04, 0x08, 0x10, 0x20}, // "\"
+    {0x41, 0x41, 0x7F, 0x00, 0x00}, // ]
+    {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
+    {0x40, 0x40, 0x40, 0x40, 0x40}, // _
+    {0x00, 0x01, 0x02, 0x04, 0x00}, // `
+    {0x20, 0x54, 0x54, 0x54, 0x78}, // a
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, // b
+    {0x38, 0x44, 0x44, 0x44, 0x20}, // c
+    {0x38, 0x44, 0x44, 0x48, 0x7F}, // d
+    {0x38, 0x54, 0x54, 0x54, 0x18}, // e
+    {0x08, 0x7E, 0x09, 0x01, 0x02}, // f
+    {0x08, 0x14, 0x54, 0x54, 0x3C}, // g
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, // h
+    {0x00, 0x44, 0x7D, 0x40, 0x00}, // i
+    {0x20, 0x40, 0x44, 0x3D, 0x00}, // j
+    {0x00, 0x7F, 0x10, 0x28, 0x44}, // k
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, // l
+    {0x7C, 0x04, 0x18, 0x04, 0x78}, // m
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, // n
+    {0x38, 0x44, 0x44, 0x44, 0x38}, // o
+    {0x7C, 0x14, 0x14, 0x14, 0x08}, // p
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, // q
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, // r
+    {0x48, 0x54, 0x54, 0x54, 0x20}, // s
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, // t
+    {0x3C, 0x40, 0x40, 0x20, 0x7C}, // u
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, // v
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, // w
+    {0x44, 0x28, 0x10, 0x28, 0x44}, // x
+    {0x0C, 0x50, 0x50, 0x50, 0x3C}, // y
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, // z
+    {0x00, 0x08, 0x36, 0x41, 0x00}, // {
+    {0x00, 0x00, 0x7F, 0x00, 0x00}, // |
+    {0x00, 0x41, 0x36, 0x08, 0x00}, // }
+    {0x08, 0x08, 0x2A, 0x1C, 0x08}, // ->
+    {0x08, 0x1C, 0x2A, 0x08, 0x08}  // <-
+};
+
+
+// ---- Compile-time table generation --------------------------------------
+// C++11 has no std::index_sequence, so build one with logarithmic
+// instantiation depth (tables here run to over a thousand entries).
+template <size_t... I> struct IndexSeq { typedef IndexSeq type; };
+
+template <class A, class B> struct ConcatSeq;
+template <size_t... A, size_t... B>
+struct ConcatSeq<IndexSeq<A...>, IndexSeq<B...> > : IndexSeq<A..., (sizeof...(A) + B)...> {};
+
+template <size_t N>
+struct MakeIndexSeq : ConcatSeq<typename MakeIndexSeq<N / 2>::type,
+                                typename MakeIndexSeq<N - N / 2>::type> {};
+template <> struct MakeIndexSeq<0> : IndexSeq<> {};
+template <> struct MakeIndexSeq<1> : IndexSeq<0> {};
+
+template <size_t N> struct ByteTable { uint8_t data[N]; };
+template <size_t N> struct GlyphTable { OLEDGlyph data[N]; };
+
+// Blank columns at either side of a 5x7 glyph, for proportional spacing
+constexpr uint8_t leadingBlank(size_t g, uint8_t col = 0) {
+    return (col == 5 || font5x7[g][col] != 0) ? col : leadingBlank(g, col + 1);
+}
+constexpr uint8_t trailingBlank(size_t g, uint8_t col = 0) {
+    return (col == 5 || font5x7[g][4 - col] != 0) ? col : trailingBlank(g, col + 1);
+}
+
+// Scaled glyphs: every source pixel becomes an S x S block. Bit b of output
+// page p is source row (p * 8 + b) / S of the source column.
+constexpr uint8_t scaledBits(uint8_t src, unsigned S, unsigned page, unsigned bit) {
+    return bit == 8 ? 0
+        : (uint8_t)((((src >> ((page * 8 + bit) / S)) & 1) << bit) | scaledBits(src, S, page, bit + 1));
+}
+
+template <unsigned S> struct Scaled {
+    static constexpr unsigned WIDTH = 5 * S;
+    static constexpr unsigned PAGES = (7 * S + 7) / 8;
+    static constexpr unsigned GLYPH_BYTES = WIDTH * PAGES;
+    static constexpr unsigned FIRST = ' ';
+    static constexpr unsigned COUNT = '9' - ' ' + 1;
+
+    static constexpr uint8_t byteAt(size_t i) {
+        return scaledBits(font5x7[FIRST - 32 + i / GLYPH_BYTES][(i % WIDTH) / S], S,
+                          (i % GLYPH_BYTES) / WIDTH, 0);
+    }
+    template <size_t... I>
+    static constexpr ByteTable<sizeof...(I)> makeBitmap(IndexSeq<I...>) {
+        return {{ byteAt(I)... }};
+    }
+    template <size_t... I>
+    static constexpr GlyphTable<sizeof...(I)> makeGlyphs(IndexSeq<I...>) {
+        return {{ { (uint16_t)(I * GLYPH_BYTES), (uint8_t)WIDTH, (uint8_t)(WIDTH + S) }... }};
+    }
+};
+
+template <size_t... I>
+constexpr GlyphTable<sizeof...(I)> makeFixedGlyphs(IndexSeq<I...>) {
+    return {{ { (uint16_t)(I * 5), 5, 6 }... }};
+}
+
+template <size_t... I>
+constexpr GlyphTable<sizeof...(I)> makePropGlyphs(IndexSeq<I...>) {
+    // Blank glyphs (space) keep a 3 px advance
+    return {{ { (uint16_t)(I * 5 + (leadingBlank(I) % 5)),
+                (uint8_t)(5 - leadingBlank(I) - (leadingBlank(I) == 5 ? 0 : trailingBlank(I))),
+                (uint8_t)(leadingBlank(I) == 5 ? 3
+                          : 5 - leadingBlank(I) - trailingBlank(I) + 1) }... }};
+}
+
+// ---- Font tables ----------------------------------------------------------
+static constexpr GlyphTable<95> fixedGlyphs = makeFixedGlyphs(MakeIndexSeq<95>());
+static constexpr GlyphTable<95> propGlyphs = makePropGlyphs(MakeIndexSeq<95>());
+
+static constexpr ByteTable<Scaled<2>::COUNT * Scaled<2>::GLYPH_BYTES> digits2xBitmap =
+    Scaled<2>::makeBitmap(MakeIndexSeq<Scaled<2>::COUNT * Scaled<2>::GLYPH_BYTES>());
+static constexpr GlyphTable<Scaled<2>::COUNT> digits2xGlyphs =
+    Scaled<2>::makeGlyphs(MakeIndexSeq<Scaled<2>::COUNT>());
+
+static constexpr ByteTable<Scaled<3>::COUNT * Scaled<3>::GLYPH_BYTES> digits3xBitmap =
+    Scaled<3>::makeBitmap(MakeIndexSeq<Scaled<3>::COUNT * Scaled<3>::GLYPH_BYTES>());
+static constexpr GlyphTable<Scaled<3>::COUNT> digits3xGlyphs =
+    Scaled<3>::makeGlyphs(MakeIndexSeq<Scaled<3>::COUNT>());
+
+extern constexpr OLEDFont Font5x7 = {
+    ' ', '~', 7, 1, 5, &font5x7[0][0], fixedGlyphs.data
+};
+extern constexpr OLEDFont Font5x7Prop = {
+    ' ', '~', 7, 1, 5, &font5x7[0][0], propGlyphs.data
+};
+extern constexpr OLEDFont FontDigits10x14 = {
+    ' ', '9', 14, Scaled<2>::PAGES, Scaled<2>::WIDTH, digits2xBitmap.data, digits2xGlyphs.data
+};
+extern constexpr OLEDFont FontDigits15x21 = {
+    ' ', '9', 21, Scaled<3>::PAGES, Scaled<3>::WIDTH, digits3xBitmap.data, digits3xGlyphs.data
+};
+
+// ---- Runtime helpers --------------------------------------------------------
+const OLEDGlyph& fontGlyph(const OLEDFont& font, char c) {
+    if (c < font.first || c > font.last) {
+        c = (font.first <= ' ' && ' ' <= font.last) ? ' ' : font.first;
+    }
+    return font.glyphs[c - font.first];
+}
+
+// Width in pixels of the inked text, without the spacing after the last glyph
+uint16_t fontTextWidth(const OLEDFont& font, const char* str) {
+    uint16_t width = 0;
+    uint8_t lastSpacing = 0;
+    for (; *str; str++) {
+        const OLEDGlyph& glyph = fontGlyph(font, *str);
+        width += glyph.advance;
+        lastSpacing = glyph.advance - glyph.width;
+    }
+    return width - lastSpacing;
+}
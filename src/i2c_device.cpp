@@ -0,0 +1,94 @@
+#include "i2c_device.h"
+
+I2CDevice::I2CDevice(TwoWire* wire, uint8_t address)
+    : _wire(wire), _address(address), transactions(0), bytesRead(0), errors(0) {}
+
+void I2CDevice::begin(TwoWire* wire, uint8_t address) {
+    _wire = wire;
+    _address = address;
+}
+
+void I2CDevice::resetStats() {
+    transactions = 0;
+    bytesRead = 0;
+    errors = 0;
+}
+
+bool I2CDevice::probe() {
+    if (_wire == nullptr) return false;
+    transactions++;
+    _wire->beginTransmission(_address);
+    if (_wire->endTransmission() != 0) {
+        errors++;
+        return false;
+    }
+    return true;
+}
+
+bool I2CDevice::writeRegister(uint8_t reg, uint8_t value) {
+    if (_wire == nullptr) return false;
+    transactions++;
+    _wire->beginTransmission(_address);
+    _wire->write(reg);
+    _wire->write(value);
+    if (_wire->endTransmission() != 0) {
+        errors++;
+        return false;
+    }
+    return true;
+}
+
+bool I2CDevice::writeCommand(uint16_t command) {
+    if (_wire == nullptr) return false;
+    transactions++;
+    _wire->beginTransmission(_address);
+    _wire->write((uint8_t)(command >> 8));
+    _wire->write((uint8_t)(command & 0xFF));
+    if (_wire->endTransmission() != 0) {
+        errors++;
+        return false;
+    }
+    return true;
+}
+
+bool I2CDevice::readRegisters(uint8_t reg, uint8_t* dst, uint8_t len) {
+    if (_wire == nullptr) return false;
+    transactions++;
+    _wire->beginTransmission(_address);
+    _wire->write(reg);
+    // Keep the bus: the read follows with a repeated start
+    if (_wire->endTransmission(false) != 0) {
+        errors++;
+        return false;
+    }
+    return finishRead(dst, len);
+}
+
+bool I2CDevice::readCommand(uint16_t command, uint8_t* dst, uint8_t len) {
+    if (_wire == nullptr) return false;
+    transactions++;
+    _wire->beginTransmission(_address);
+    _wire->write((uint8_t)(command >> 8));
+    _wire->write((uint8_t)(command & 0xFF));
+    if (_wire->endTransmission(false) != 0) {
+        errors++;
+        return false;
+    }
+    return finishRead(dst, len);
+}
+
+bool I2CDevice::read(uint8_t* dst, uint8_t len) {
+    if (_wire == nullptr) return false;
+    transactions++;
+    return finishRead(dst, len);
+}
+
+bool I2CDevice::finishRead(uint8_t* dst, uint8_t len) {
+    if (_wire->requestFrom(_address, len) != len || _wire->available() < len) {
+        errors++;
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++) dst[i] = _wire->read();
+    bytesRead += len;
+    return true;
+}
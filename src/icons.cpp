@@ -0,0 +1,20 @@
+#include "icons.h"
+
+static const uint8_t iconSatelliteData[] = {
+    0x00, 0x0C, 0x1E, 0x3E, 0x7C, 0xB8, 0xD0, 0xE0, 0xC0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x07, 0x13, 0x25, 0x4A, 0x54, 0x28, 0x10, 0x00
+};
+
+static const uint8_t iconSignalBarsData[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x00, 0x00, 0xF0, 0xF0, 0x00, 0x00, 0xFE, 0xFE, 0x00,
+    0x00, 0x3C, 0x3C, 0x00, 0x00, 0x3F, 0x3F, 0x00, 0x00, 0x3F, 0x3F, 0x00, 0x00, 0x3F, 0x3F, 0x00
+};
+
+static const uint8_t iconBatteryData[] = {
+    0x00, 0xF0, 0x10, 0xD0, 0xD0, 0x10, 0xD0, 0xD0, 0x10, 0xD0, 0xD0, 0x10, 0xF0, 0x40, 0x40, 0xC0,
+    0x00, 0x0F, 0x08, 0x0B, 0x0B, 0x08, 0x0B, 0x0B, 0x08, 0x0B, 0x0B, 0x08, 0x0F, 0x02, 0x02, 0x03
+};
+
+const OLEDBitmap IconSatellite = { 16, 16, iconSatelliteData };
+const OLEDBitmap IconSignalBars = { 16, 16, iconSignalBarsData };
+const OLEDBitmap IconBattery = { 16, 16, iconBatteryData };
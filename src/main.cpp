@@ -3,28 +3,63 @@
 #include "sht30.h"     // Temperature and humidity sensor
 #include "OLED.h"
 #include "bmp180.h"
+#include "variometer.h"
+#include "bmp180_oss_policy.h"
+#include "sea_level_calibrator.h"
+#include "dashboard.h"
+#include "sparkline.h"
+#include "render_scheduler.h"
+#include "screen_mirror.h"
 #include <Wire.h>
 #include <math.h>
 
 // Function Prototypes
 void initBMP180();
 void initSHT30();
-void calibrateSeaLevel(float knownAltM);
+void applySeaLevel(float newSeaLevelPa, float knownAltM);
 void readBMP180Data();
 void readSHT30Data();
+void initDashboard();
 void displaySensorData();
 void displayCombinedSensorData();
 void updateHybridAltimeter();
 float getHybridAltitude();
-String getAltitudeSource();
-
-static float seaLevelPressureFrom(float pressurePa, float knownAltitudeM);
+const char* getAltitudeSource();
 
 // Sensor Classes
 OLED display;
+Dashboard dashboard(display);
+
+// Altitude trend to the right of the SHT30 rows: 30 columns over pages 3-4,
+// one sample every 10 s, so the chart spans the last 5 minutes. Each sample
+// scrolls the chart, about 45 bus bytes (host-counted) once per interval.
+Sparkline altitudeTrend(display, 98, 3, 30, 2);
+const unsigned long TREND_INTERVAL = 10000; // ms
+unsigned long lastTrendSample = 0;
+
+// Redraw the screen only when something it shows has changed
+const uint8_t DISPLAY_MAX_FPS = 5;
+RenderScheduler renderScheduler(DISPLAY_MAX_FPS);
 BMP180 bmp180;
 SHT30 sht30;
 
+// Set to 0 to sample the BMP180 once per sensorInterval instead of running
+// it flat out through the variometer filter
+#define BARO_STREAMING 1
+Variometer vario;
+// Oversampling per sample: averaged high OSS when still, fast low OSS when
+// climbing or sinking. Budget is the time per sample, target the RMS noise.
+const float BARO_BUDGET_MS = 100.0f;
+const float BARO_NOISE_TARGET_PA = 2.0f;
+BMP180OssPolicy ossPolicy(BARO_BUDGET_MS, BARO_NOISE_TARGET_PA);
+
+// Set to 1 to mirror the screen over Serial for tools/oled_mirror.py (the
+// viewer passes the normal log text through)
+#define SCREEN_MIRROR_SERIAL 0
+#if SCREEN_MIRROR_SERIAL
+ScreenMirror screenMirror(Serial);
+#endif
+
 // ====== Second I2C bus (Heltec/MakerFocus V3 uses Wire1 on custom pins) ======
 TwoWire I2C_second = TwoWire(1);
 #define SDA2_PIN 7
@@ -32,10 +67,13 @@ TwoWire I2C_second = TwoWire(1);
 
 // BMP180 Related Global variables
 bool  bmp180_ready = false;
+BMP180Sample baroSample;      // Latest sample, altitudes for {std, calibrated} SLP
 float temperatureF = 0.0f;   // Fahrenheit from BMP180
 float pressurePa   = 0.0f;   // Pascals
 float altitudeStd  = 0.0f;   // meters (Std Atmosphere 101325 Pa)
 float altitudeCal  = 0.0f;   // meters (Calibrated with local SLP)
+float varioAltitude = 0.0f;  // meters, filtered altitudeCal (BARO_STREAMING)
+float verticalSpeed = 0.0f;  // m/s, positive when climbing (BARO_STREAMING)
 bool  calibrated   = false;
 static const float SEA_LEVEL_DEFAULT_PA = 101325.0f; // Standard Atmosphere
 float seaLevelPa = SEA_LEVEL_DEFAULT_PA;             // Set after calibration
@@ -48,13 +86,26 @@ float humidity = 0.0f;        // %RH from SHT30
 float temperatureC_SHT = 0.0f; // Celsius from SHT30
 float temperatureF_SHT = 0.0f; // Fahrenheit from SHT30
 
+// Dashboard field ids (assigned in initDashboard)
+int fieldBmpTemp = -1;
+int fieldPressure = -1;
+int fieldShtTemp = -1;
+int fieldHumidity = -1;
+int fieldAltitude = -1;
+int fieldGPS = -1;
+
 // Hybrid Altimeter Variables
 bool autoCalibrated = false;
 unsigned long lastGPSCalibration = 0;
 const unsigned long RECALIBRATION_INTERVAL = 300000; // 5 minutes
+const unsigned long CALIBRATION_RETRY = 30000;       // After a failed attempt
+SeaLevelCalibrator seaLevelCalibrator;               // Fed from the normal sampling path
 
 void setup() {
   Serial2.begin(9600, SERIAL_8N1,46,45);
+#if SCREEN_MIRROR_SERIAL
+  Serial.setTxBufferSize(4096); // Room for a keyframe, so mirroring never blocks
+#endif
   Serial.begin(115200);
   delay(1000);
   
@@ -63,6 +114,9 @@ void setup() {
   
   // OLED
   display.init();
+#if SCREEN_MIRROR_SERIAL
+  display.setScreenMirror(&screenMirror);
+#endif
   
   // I2C (second bus)
   I2C_second.begin(SDA2_PIN, SCL2_PIN, 100000); // 100 kHz
@@ -72,6 +126,22 @@ void setup() {
   
   // SHT30
   initSHT30();
+
+  // Static screen layout depends on which sensors came up
+  initDashboard();
+
+  // Values shown on the dashboard, at the resolution they are printed with;
+  // GPS fixes invalidate the scheduler directly
+  renderScheduler.subscribe(temperatureF, 0.1f);
+  renderScheduler.subscribe(pressurePa, 10.0f);     // Shown in 0.1 hPa
+  renderScheduler.subscribe(altitudeCal, 0.1f);
+#if BARO_STREAMING
+  renderScheduler.subscribe(varioAltitude, 0.1f);
+  renderScheduler.subscribe(verticalSpeed, 0.1f);
+#endif
+  renderScheduler.subscribe(temperatureF_SHT, 0.1f);
+  renderScheduler.subscribe(humidity, 0.1f);
+  renderScheduler.subscribe(autoCalibrated);
   
   Serial.println("System initialized. GPS will auto-calibrate BMP180 when available.");
 }
@@ -79,9 +149,18 @@ void setup() {
 void loop() {
   bool newGPSData = false;
   
+  // BMP180 conversions run in the background; pick up each finished sample
+#if BARO_STREAMING
+  if (bmp180_ready && bmp180.tick(0)) {
+#else
+  if (bmp180_ready && bmp180.tick(sensorInterval)) {
+#endif
+    readBMP180Data();
+    seaLevelCalibrator.addSample(baroSample.pressure, baroSample.timestamp);
+  }
+
   // Read sensor data periodically
   if (millis() - lastSensorRead >= sensorInterval) {
-    readBMP180Data();
     readSHT30Data();
     lastSensorRead = millis();
   }
@@ -91,16 +170,31 @@ void loop() {
   
   // Update hybrid altimeter (auto-calibration)
   updateHybridAltimeter();
+
+  // The trend draws straight into the back buffer; the next frame sends it
+  if (millis() - lastTrendSample >= TREND_INTERVAL) {
+    lastTrendSample = millis();
+    float trendAlt = getHybridAltitude();
+    if (trendAlt != -999.0f) {
+      altitudeTrend.addSample(trendAlt);
+      renderScheduler.invalidate();
+    }
+  }
   
   // Display combined data only when we have new GPS data
   if (newGPSData) {
     displayCombinedSensorData();
+    renderScheduler.invalidate();
   }
   
-  // Update display
-  display.clearDisplay();
-  displaySensorData();
-  display.updateDisplay();
+  // Update display: render a new frame only when a shown value changed and
+  // the previous frame has been sent, then stream a slice of it so GPS and
+  // sensors are never starved
+  if (!display.isFlushBusy() && renderScheduler.shouldRender()) {
+    displaySensorData();
+    display.present();
+  }
+  display.flushStep();
 }
 
 // ====== BMP180 Implementation ======
@@ -108,7 +202,12 @@ void initBMP180() {
   Serial.println(F("Initializing BMP180..."));
   if (bmp180.begin(&I2C_second, BMP180_OSS_ULTRAHIGHRES)) {
     bmp180_ready = true;
+    // Temperature drifts slowly: refresh it every 10 pressure reads or 5 s
+    bmp180.setTemperatureRefresh(10, 5000);
     Serial.println(F("BMP180 initialized successfully"));
+    Serial.print(F("BMP180 boot: ")); Serial.print(bmp180.getBootTransactions());
+    Serial.println(bmp180.calibrationFromCache() ? F(" I2C transfers, calibration from NVS")
+                                                 : F(" I2C transfers, calibration read from chip"));
   } else {
     bmp180_ready = false;
     Serial.println(F("BMP180 initialization failed"));
@@ -120,6 +219,11 @@ void initSHT30() {
   Serial.println(F("Initializing SHT30..."));
   if (sht30.begin(&I2C_second)) {
     sht30_ready = true;
+    // Let it measure on its own; readSHT30Data() then only fetches, with no
+    // wait. Two per second always leaves a fresh one for each sensorInterval.
+    if (!sht30.startPeriodic(SHT30_RATE_2)) {
+      Serial.println(F("SHT30 periodic mode failed, using single shot"));
+    }
     Serial.println(F("SHT30 initialized successfully"));
   } else {
     sht30_ready = false;
@@ -139,64 +243,72 @@ void readSHT30Data() {
   }
 }
 
-// Average a few pressure samples, compute sea-level pressure from known altitude
-void calibrateSeaLevel(float knownAltM) {
-  const int N = 8; // sample count for averaging
-  float sumPa = 0.0f;
-  for (int i = 0; i < N; ++i) {
-    float p = bmp180.readPressure(); // Pa
-    if (p > 10000.0f && p < 120000.0f) { // rough sanity
-      sumPa += p;
-    } else {
-      // If a weird value appears, don't skew the average; repeat this sample
-      --i;
-    }
-    delay(60);
-  }
-  float pNow = sumPa / N; // Pa
-  seaLevelPa = seaLevelPressureFrom(pNow, knownAltM);
+// Switch every altitude over to a new sea-level reference in one step
+void applySeaLevel(float newSeaLevelPa, float knownAltM) {
+  seaLevelPa = newSeaLevelPa;
   calibrated = true;
+  vario.reset(); // The reference changed, so the altitude jumps
+  altitudeTrend.clear();
+  readBMP180Data(); // Refresh the calibrated altitude from the last sample
   Serial.println("BMP180 calibrated to altitude: " + String(knownAltM) + "m, SLP: " + String(seaLevelPa/100.0f) + "hPa");
 }
 
-// Rearranged barometric formula to compute SLP (QNH) from known altitude
-static float seaLevelPressureFrom(float pressurePa, float knownAltitudeM) {
-  // seaLevelPa = pressurePa / (1 - h/44330)^5.255
-  return pressurePa / powf(1.0f - (knownAltitudeM / 44330.0f), 5.255f);
-}
-
 void readBMP180Data() {
   if (!bmp180_ready) return;
+  // Latest sample from bmp180.tick(), with altitudes for both references
+  const float references[2] = { SEA_LEVEL_DEFAULT_PA, seaLevelPa };
+  baroSample = bmp180.lastSample(references, calibrated ? 2 : 1);
+  if (!baroSample.valid) return;
   // Temperature (sensor returns °C)
-  float tempC = bmp180.readTemperature();
-  temperatureF = (tempC * 9.0f / 5.0f) + 32.0f;
+  temperatureF = (baroSample.temperature * 9.0f / 5.0f) + 32.0f;
   // Pressure (Pa)
-  pressurePa = bmp180.readPressure();
+  pressurePa = baroSample.pressure;
   // Altitude with standard sea-level pressure (101325 Pa)
-  altitudeStd = bmp180.readAltitude(SEA_LEVEL_DEFAULT_PA);
+  altitudeStd = baroSample.altitude[0];
   // Altitude
   if (calibrated) {
-    altitudeCal = bmp180.readAltitude(seaLevelPa);
+    altitudeCal = baroSample.altitude[1];
   } else {
     altitudeCal = altitudeStd; // until calibrated, just mirror std
   }
+
+#if BARO_STREAMING
+  // The same altitude in centimetres, into the variometer filter
+  if (vario.update((int32_t)lroundf(altitudeCal * 100.0f), baroSample.timestamp)) {
+    varioAltitude = vario.getAltitude();
+    verticalSpeed = vario.getSpeed();
+  }
+  // Settings for the next sample
+  ossPolicy.apply(bmp180, ossPolicy.choose(verticalSpeed, millis()));
+#endif
 }
 
 // ====== Hybrid Altimeter Implementation ======
 void updateHybridAltimeter() {
+  // A calibration collects samples in the background; pick up its result
+  seaLevelCalibrator.update(millis());
+  float newSeaLevelPa, gpsAltUsed;
+  if (seaLevelCalibrator.takeResult(&newSeaLevelPa, &gpsAltUsed)) {
+    applySeaLevel(newSeaLevelPa, gpsAltUsed);
+    autoCalibrated = true;
+    Serial.println("Auto-calibrated BMP180 with GPS altitude: " + String(gpsAltUsed, 1) + "m");
+  } else if (seaLevelCalibrator.getState() == SEA_LEVEL_FAILED) {
+    seaLevelCalibrator.cancel();
+    lastGPSCalibration = millis() - RECALIBRATION_INTERVAL + CALIBRATION_RETRY;
+    Serial.println("BMP180 calibration failed after " + String(seaLevelCalibrator.getRejects()) + " rejected samples");
+  }
+
   // Auto-calibrate with GPS when available
   if (isLocationValid() && isAltitudeValid() && bmp180_ready &&
+      !seaLevelCalibrator.isRunning() &&
       (millis() - lastGPSCalibration > RECALIBRATION_INTERVAL)) {
     
     float gpsAlt = getGPSAltitude();
     
     // Sanity check GPS altitude (reasonable range)
     if (gpsAlt > -500.0f && gpsAlt < 9000.0f) {
-      calibrateSeaLevel(gpsAlt);
-      autoCalibrated = true;
+      seaLevelCalibrator.start(gpsAlt, millis());
       lastGPSCalibration = millis();
-      
-      Serial.println("Auto-calibrated BMP180 with GPS altitude: " + String(gpsAlt, 1) + "m");
     }
   }
 }
@@ -204,7 +316,10 @@ void updateHybridAltimeter() {
 float getHybridAltitude() {
   if (autoCalibrated && bmp180_ready) {
     // Use calibrated barometric reading for precision
-    return bmp180.readAltitude(seaLevelPa);
+#if BARO_STREAMING
+    if (vario.isValid()) return varioAltitude;
+#endif
+    return altitudeCal;
   } else if (isAltitudeValid()) {
     // Fall back to GPS when barometric not calibrated
     return getGPSAltitude();
@@ -212,40 +327,67 @@ float getHybridAltitude() {
   return -999.0f; // No valid reading
 }
 
-String getAltitudeSource() {
+const char* getAltitudeSource() {
   if (autoCalibrated && bmp180_ready) return "BAR";
   else if (isAltitudeValid()) return "GPS";
   return "NONE";
 }
 
+void initDashboard() {
+  dashboard.addLabel(0, 0,  "BMP Temp:");
+  fieldBmpTemp = dashboard.addField(60, 0, 11);
+  dashboard.addLabel(0, 10, "Pressure:");
+  fieldPressure = dashboard.addField(60, 10, 11);
+
+  // Narrow enough ("-10.5F", "100.0%") to stay clear of the altitude trend
+  if (sht30_ready) {
+    dashboard.addLabel(0, 20, "SHT Temp:");
+    fieldShtTemp = dashboard.addField(60, 20, 6);
+    dashboard.addLabel(0, 30, "Humidity:");
+    fieldHumidity = dashboard.addField(60, 30, 6);
+  } else {
+    dashboard.addLabel(0, 20, "SHT30: Not Ready");
+  }
+
+  // Altitude source (BAR/GPS) is part of the field since it can change
+  dashboard.addLabel(0, 40, "Alt");
+  fieldAltitude = dashboard.addField(18, 40, 18);
+  dashboard.addLabel(0, 50, "GPS:");
+  fieldGPS = dashboard.addField(30, 50, 16);
+
+  dashboard.begin();
+}
+
+// Only fields whose formatted text changed are redrawn and marked dirty
 void displaySensorData() {
   // Show BMP180 temperature and pressure
-  display.drawString(0, 0,  "BMP Temp: " + String(temperatureF, 1) + "F");
-  display.drawString(0, 10, "Pressure: " + String(pressurePa / 100.0f, 1) + "hPa");
+  dashboard.setFieldf(fieldBmpTemp, "%.1fF", temperatureF);
+  dashboard.setFieldf(fieldPressure, "%.1fhPa", pressurePa / 100.0f);
   
   // Show SHT30 temperature and humidity
   if (sht30_ready) {
-    display.drawString(0, 20, "SHT Temp: " + String(temperatureF_SHT, 1) + "F");
-    display.drawString(0, 30, "Humidity: " + String(humidity, 1) + "%");
-  } else {
-    display.drawString(0, 20, "SHT30: Not Ready");
+    dashboard.setFieldf(fieldShtTemp, "%.1fF", temperatureF_SHT);
+    dashboard.setFieldf(fieldHumidity, "%.1f%%", humidity);
   }
   
   // Show hybrid altitude with source indicator
   float hybridAlt = getHybridAltitude();
-  String altSource = getAltitudeSource();
   
   if (hybridAlt != -999.0f) {
-    display.drawString(0, 40, "Alt " + altSource + ": " + String(hybridAlt, 1) + "m");
+#if BARO_STREAMING
+    dashboard.setFieldf(fieldAltitude, " %s:%.1fm %+.1f", getAltitudeSource(), hybridAlt, verticalSpeed);
+#else
+    dashboard.setFieldf(fieldAltitude, " %s: %.1fm", getAltitudeSource(), hybridAlt);
+#endif
   } else {
-    display.drawString(0, 40, "Altitude: No Data");
+    dashboard.setField(fieldAltitude, ": No Data");
   }
   
   // Display GPS coordinates
   if (isLocationValid()) {
-    display.drawString(0, 50, "GPS: " + getFormattedCoordinates());
+    dashboard.setFieldf(fieldGPS, "%.6f,%.6f", getLatitude(), getLongitude());
   } else {
-    display.drawString(0, 50, "GPS: No Fix");
+    dashboard.setField(fieldGPS, "No Fix");
   }
 }
 
@@ -312,6 +454,28 @@ void displayCombinedSensorData() {
     Serial.print(getGPSAltitude(), 1); Serial.print(F("m, "));
   }
   
+#if BARO_STREAMING
+  // Variometer output with its measured latency and noise
+  Serial.print(F("Vario = ")); Serial.print(verticalSpeed, 2);
+  Serial.print(F("m/s @ ")); Serial.print(vario.getSampleIntervalMs(), 1);
+  Serial.print(F("ms, lag ")); Serial.print(vario.getSpeedLatencyMs(), 0);
+  Serial.print(F("ms, noise alt/speed/sensor ")); Serial.print(vario.getAltitudeNoiseCm(), 1);
+  Serial.print(F("/")); Serial.print(vario.getSpeedNoiseCms(), 1);
+  Serial.print(F("/")); Serial.print(vario.getSensorNoiseCm(), 1);
+  Serial.print(F("cm, OSS ")); Serial.print(baroSample.oss);
+  Serial.print(F("x")); Serial.print(baroSample.averaged);
+  Serial.print(ossPolicy.getChoice().moving ? F(" moving, ") : F(" still, "));
+#endif
+  Serial.print(F("I2C/sample = ")); Serial.print(bmp180.getSampleTransactions());
+  Serial.print(F(", "));
+
+  // Display scheduler statistics
+  Serial.print(F("Frames rendered/skipped/throttled = "));
+  Serial.print(renderScheduler.getFramesRendered()); Serial.print(F("/"));
+  Serial.print(renderScheduler.getFramesSkipped()); Serial.print(F("/"));
+  Serial.print(renderScheduler.getFramesThrottled());
+  Serial.print(F(", "));
+  
   // Then print GPS data (also without newline)
   displayGPSInfo();
   
@@ -0,0 +1,136 @@
+#include "oled_backend.h"
+
+// Power-on configuration, sent as a single command stream
+static const uint8_t ssd1306InitSequence[] = {
+    SSD1306_DISPLAYOFF,
+    SSD1306_SETDISPLAYCLOCKDIV, 0xF0,
+    SSD1306_SETMULTIPLEX, SCREEN_HEIGHT - 1,
+    SSD1306_SETDISPLAYOFFSET, 0x00,
+    SSD1306_SETSTARTLINE,
+    SSD1306_CHARGEPUMP, 0x14,
+    SSD1306_MEMORYMODE, 0x00,
+    SSD1306_SEGREMAP | 0x01,
+    SSD1306_COMSCANDEC,
+    SSD1306_SETCOMPINS, 0x12,
+    SSD1306_SETCONTRAST, 0xCF,
+    SSD1306_SETPRECHARGE, 0xF1,
+    SSD1306_SETVCOMDETECT, 0x40,
+    SSD1306_DISPLAYALLON_RESUME,
+    SSD1306_NORMALDISPLAY,
+    SSD1306_DEACTIVATE_SCROLL,
+    SSD1306_DISPLAYON
+};
+
+// SH1106 equivalent: DC-DC converter instead of the charge pump, no memory
+// mode (page addressing only) and no scroll engine
+static const uint8_t sh1106InitSequence[] = {
+    SSD1306_DISPLAYOFF,
+    SSD1306_SETDISPLAYCLOCKDIV, 0x80,
+    SSD1306_SETMULTIPLEX, SCREEN_HEIGHT - 1,
+    SSD1306_SETDISPLAYOFFSET, 0x00,
+    SSD1306_SETSTARTLINE,
+    SH1106_DCDC, 0x8B,
+    SSD1306_SEGREMAP | 0x01,
+    SSD1306_COMSCANDEC,
+    SSD1306_SETCOMPINS, 0x12,
+    SSD1306_SETCONTRAST, 0xCF,
+    SSD1306_SETPRECHARGE, 0x1F,
+    SSD1306_SETVCOMDETECT, 0x40,
+    SH1106_SETPUMPVOLTAGE | 0x03,
+    SSD1306_DISPLAYALLON_RESUME,
+    SSD1306_NORMALDISPLAY,
+    SSD1306_DISPLAYON
+};
+
+const uint16_t SSD1306I2C::MAX_PAYLOAD;
+
+SSD1306I2C::SSD1306I2C(TwoWire* wire, uint8_t address)
+    : _wire(wire), _address(address), transactions(0) {}
+
+bool SSD1306I2C::begin(int sda, int scl, uint32_t clockHz) {
+    return _wire->begin(sda, scl, clockHz);
+}
+
+void SSD1306I2C::setClock(uint32_t clockHz) {
+    _wire->setClock(clockHz);
+}
+
+bool SSD1306I2C::probe() {
+    _wire->beginTransmission(_address);
+    return _wire->endTransmission() == 0;
+}
+
+void SSD1306I2C::sendCommands(const uint8_t* cmds, uint16_t count) {
+    // Long lists may split a command from its arguments; the controller's
+    // command decoder keeps its state across transactions
+    while (count > 0) {
+        uint16_t n = (count > MAX_PAYLOAD) ? MAX_PAYLOAD : count;
+        write(SSD1306_CONTROL_CMD_STREAM, cmds, n);
+        cmds += n;
+        count -= n;
+    }
+}
+
+void SSD1306I2C::sendData(const uint8_t* data, uint16_t count) {
+    while (count > 0) {
+        uint16_t n = (count > MAX_PAYLOAD) ? MAX_PAYLOAD : count;
+        write(SSD1306_CONTROL_DATA_STREAM, data, n);
+        data += n;
+        count -= n;
+    }
+}
+
+void SSD1306I2C::write(uint8_t control, const uint8_t* bytes, uint16_t count) {
+    transactions++;
+    _wire->beginTransmission(_address);
+    _wire->write(control);
+    _wire->write(bytes, count);
+    _wire->endTransmission();
+}
+
+OLEDI2CBackend::OLEDI2CBackend(TwoWire* wire, uint8_t address, int8_t sdaPin,
+                               int8_t sclPin, int8_t rstPin, int8_t vextPin)
+    : bus(wire, address), sda(sdaPin), scl(sclPin), rst(rstPin), vext(vextPin) {}
+
+bool OLEDI2CBackend::powerUp(uint32_t clockHz) {
+    // Step 1: Power control
+    if (vext != -1) {
+        pinMode(vext, OUTPUT);
+        digitalWrite(vext, LOW);  // Enable power
+        delay(100);
+    }
+    // Step 2: Reset sequence
+    if (rst != -1) {
+        pinMode(rst, OUTPUT);
+        digitalWrite(rst, HIGH);
+        delay(1);
+        digitalWrite(rst, LOW);
+        delay(1);
+        digitalWrite(rst, HIGH);
+        delay(1);
+    }
+    // Step 3: Initialize I2C
+    bus.begin(sda, scl, clockHz);
+    delay(100);
+    // Step 4: Check if device responds
+    return bus.probe();
+}
+
+bool SSD1306Backend::begin(uint32_t clockHz) {
+    if (!powerUp(clockHz)) return false;
+    bus.sendCommands(ssd1306InitSequence, sizeof(ssd1306InitSequence));
+    return true;
+}
+
+bool SH1106Backend::begin(uint32_t clockHz) {
+    if (!powerUp(clockHz)) return false;
+    bus.sendCommands(sh1106InitSequence, sizeof(sh1106InitSequence));
+    return true;
+}
+
+bool MemoryBackend::begin(uint32_t clockHz) {
+    (void)clockHz;
+    emulator->reset();
+    sendCommands(ssd1306InitSequence, sizeof(ssd1306InitSequence));
+    return true;
+}
@@ -0,0 +1,96 @@
+#include "render_scheduler.h"
+#include <math.h>
+
+RenderScheduler::RenderScheduler(uint8_t maxFps)
+    : subscriptionCount(0), snapshotUsed(0), lastRender(0), lastSlot(0), dirty(true), throttled(false),
+      framesRendered(0), framesSkipped(0), framesThrottled(0) {
+    setMaxFps(maxFps);
+}
+
+void RenderScheduler::setMaxFps(uint8_t maxFps) {
+    minIntervalMs = (maxFps == 0) ? 0 : 1000UL / maxFps;
+}
+
+bool RenderScheduler::subscribe(const void* value, uint8_t size) {
+    return add(value, size, 0.0f);
+}
+
+bool RenderScheduler::subscribe(const float& value, float resolution) {
+    if (resolution <= 0.0f) return add(&value, sizeof(float), 0.0f);
+    return add(&value, sizeof(int32_t), resolution);
+}
+
+bool RenderScheduler::add(const void* value, uint8_t size, float resolution) {
+    if (subscriptionCount >= RENDER_MAX_SUBSCRIPTIONS) return false;
+    if (snapshotUsed + size > RENDER_SNAPSHOT_BYTES) return false;
+    Subscription& sub = subscriptions[subscriptionCount++];
+    sub.value = static_cast<const uint8_t*>(value);
+    sub.size = size;
+    sub.offset = snapshotUsed;
+    sub.resolution = resolution;
+    snapshotUsed += size;
+    dirty = true;
+    return true;
+}
+
+void RenderScheduler::invalidate() {
+    dirty = true;
+}
+
+// Compare every subscription against its snapshot. With refresh, update the
+// snapshot in the same pass, so the next frame is judged against what this
+// one shows; without, stop at the first change.
+bool RenderScheduler::pollChanges(bool refresh) {
+    bool changed = false;
+    for (uint8_t i = 0; i < subscriptionCount; i++) {
+        const Subscription& sub = subscriptions[i];
+        const uint8_t* current = sub.value;
+        int32_t rounded;
+        if (sub.resolution > 0.0f) {
+            float value;
+            memcpy(&value, sub.value, sizeof(value));
+            rounded = isnan(value) ? INT32_MIN : (int32_t)lroundf(value / sub.resolution);
+            current = reinterpret_cast<const uint8_t*>(&rounded);
+        }
+        if (memcmp(&snapshot[sub.offset], current, sub.size) != 0) {
+            if (!refresh) return true;
+            memcpy(&snapshot[sub.offset], current, sub.size);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool RenderScheduler::shouldRender(unsigned long now) {
+    if (now - lastRender < minIntervalMs) {
+        // Count each frame the rate limit delays once, not every call
+        if (!throttled && (dirty || pollChanges(false))) {
+            throttled = true;
+            framesThrottled++;
+        }
+        return false;
+    }
+
+    bool changed = pollChanges(true) || dirty;
+    if (!changed) {
+        // An idle slot is polled on every loop pass; count it once per frame
+        // interval so skips and renders add up to the frame slots elapsed
+        if (now - lastSlot >= minIntervalMs) {
+            lastSlot = now;
+            framesSkipped++;
+        }
+        return false;
+    }
+    dirty = false;
+    throttled = false;
+    lastRender = now;
+    lastSlot = now;
+    framesRendered++;
+    return true;
+}
+
+void RenderScheduler::resetStats() {
+    framesRendered = 0;
+    framesSkipped = 0;
+    framesThrottled = 0;
+}
@@ -0,0 +1,81 @@
+#include "screen_mirror.h"
+
+ScreenMirror::ScreenMirror(Print& out, bool dropWhenBusy)
+    : _out(out), _dropWhenBusy(dropWhenBusy), sequence(0), sinceKeyframe(0),
+      keyframePending(true), framesSent(0), framesDropped(0), bytesSent(0) {
+    memset(reference, 0, BUFFER_SIZE);
+}
+
+bool ScreenMirror::sendFrame(const uint8_t* frame, uint8_t startLine) {
+    bool keyframe = keyframePending || sinceKeyframe >= SCREEN_MIRROR_KEYFRAME_INTERVAL;
+    uint16_t payload = 0;
+    if (keyframe) {
+        payload = encode(frame, nullptr, packet + SCREEN_MIRROR_HEADER_SIZE);
+    } else if (memcmp(frame, reference, BUFFER_SIZE) != 0) {
+        payload = encode(frame, reference, packet + SCREEN_MIRROR_HEADER_SIZE);
+    }
+
+    packet[0] = SCREEN_MIRROR_SYNC0;
+    packet[1] = SCREEN_MIRROR_SYNC1;
+    packet[2] = keyframe ? SCREEN_MIRROR_KEYFRAME : SCREEN_MIRROR_DELTA;
+    packet[3] = sequence;
+    packet[4] = startLine;
+    packet[5] = payload & 0xFF;
+    packet[6] = payload >> 8;
+    uint16_t length = SCREEN_MIRROR_HEADER_SIZE + payload;
+    uint8_t checksum = 0;
+    for (uint16_t i = 2; i < length; i++) checksum += packet[i];
+    packet[length++] = checksum;
+
+    if (_dropWhenBusy && _out.availableForWrite() < length) {
+        framesDropped++;
+        return false;
+    }
+    _out.write(packet, length);
+
+    memcpy(reference, frame, BUFFER_SIZE);
+    sequence++;
+    sinceKeyframe = keyframe ? 0 : sinceKeyframe + 1;
+    keyframePending = false;
+    framesSent++;
+    bytesSent += length;
+    return true;
+}
+
+// PackBits-style RLE of frame, or of frame ^ base when base is given. Runs
+// of three or more equal bytes (mostly zeros in a delta) become two bytes.
+uint16_t ScreenMirror::encode(const uint8_t* frame, const uint8_t* base, uint8_t* dst) const {
+    uint16_t n = 0;
+    uint16_t i = 0;
+    while (i < BUFFER_SIZE) {
+        uint8_t value = base ? frame[i] ^ base[i] : frame[i];
+        uint16_t run = 1;
+        while (i + run < BUFFER_SIZE && run < 130 &&
+               (base ? frame[i + run] ^ base[i + run] : frame[i + run]) == value) {
+            run++;
+        }
+        if (run >= 3) {
+            dst[n++] = 0x80 | (run - 3);
+            dst[n++] = value;
+            i += run;
+            continue;
+        }
+
+        // Literal bytes up to the next run of three or the 128-byte limit
+        uint16_t control = n++;
+        uint8_t count = 0;
+        while (i < BUFFER_SIZE && count < 128) {
+            uint8_t b0 = base ? frame[i] ^ base[i] : frame[i];
+            if (i + 2 < BUFFER_SIZE) {
+                uint8_t b1 = base ? frame[i + 1] ^ base[i + 1] : frame[i + 1];
+                uint8_t b2 = base ? frame[i + 2] ^ base[i + 2] : frame[i + 2];
+                if (count > 0 && b0 == b1 && b0 == b2) break;
+            }
+            dst[n++] = b0;
+            i++;
+            count++;
+        }
+        dst[control] = count - 1;
+    }
+    return n;
+}
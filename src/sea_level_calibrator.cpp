@@ -0,0 +1,86 @@
+#include "sea_level_calibrator.h"
+#include "baro_math.h"
+#include <math.h>
+
+// Median of the first n values; sorts a copy
+static float median(const float* values, uint8_t n) {
+    float sorted[SEA_LEVEL_MAX_SAMPLES];
+    for (uint8_t i = 0; i < n; i++) {
+        float v = values[i];
+        uint8_t j = i;
+        for (; j > 0 && sorted[j - 1] > v; j--) sorted[j] = sorted[j - 1];
+        sorted[j] = v;
+    }
+    return (n & 1) ? sorted[n / 2] : 0.5f * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+SeaLevelCalibrator::SeaLevelCalibrator(uint8_t samples, uint8_t maxRejects, uint32_t timeoutMs)
+    : _samples(constrain(samples, (uint8_t)3, (uint8_t)SEA_LEVEL_MAX_SAMPLES)),
+      _maxRejects(maxRejects), _timeoutMs(timeoutMs), state(SEA_LEVEL_IDLE),
+      altitudeM(0), startMs(0), count(0), rejects(0), result(0), spreadPa(0) {}
+
+void SeaLevelCalibrator::start(float knownAltitudeM, uint32_t nowMs) {
+    altitudeM = knownAltitudeM;
+    startMs = nowMs;
+    count = 0;
+    rejects = 0;
+    spreadPa = 0;
+    state = SEA_LEVEL_COLLECTING;
+}
+
+void SeaLevelCalibrator::addSample(float pressurePa, uint32_t nowMs) {
+    update(nowMs);
+    if (state != SEA_LEVEL_COLLECTING) return;
+
+    if (!(pressurePa > SEA_LEVEL_MIN_PA && pressurePa < SEA_LEVEL_MAX_PA)) {
+        reject();
+        return;
+    }
+    buffer[count++] = pressurePa;
+    if (count == _samples) evaluate();
+}
+
+void SeaLevelCalibrator::update(uint32_t nowMs) {
+    if (state == SEA_LEVEL_COLLECTING && nowMs - startMs > _timeoutMs) {
+        state = SEA_LEVEL_FAILED;
+    }
+}
+
+void SeaLevelCalibrator::reject() {
+    if (++rejects > _maxRejects) state = SEA_LEVEL_FAILED;
+}
+
+// Drop outliers from a full buffer; finish if none were found
+void SeaLevelCalibrator::evaluate() {
+    float center = median(buffer, count);
+    float deviations[SEA_LEVEL_MAX_SAMPLES];
+    for (uint8_t i = 0; i < count; i++) deviations[i] = fabsf(buffer[i] - center);
+    float mad = median(deviations, count);
+    float limit = max(SEA_LEVEL_OUTLIER_PA, 4.0f * mad);
+
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (deviations[i] <= limit) {
+            buffer[kept++] = buffer[i];
+        } else {
+            reject();
+        }
+    }
+    if (state != SEA_LEVEL_COLLECTING) return;
+    count = kept;
+    if (kept < _samples) return;   // Collect replacements
+
+    float sum = 0.0f;
+    for (uint8_t i = 0; i < count; i++) sum += buffer[i];
+    result = baroSeaLevel(sum / count, altitudeM);
+    spreadPa = mad;
+    state = SEA_LEVEL_DONE;
+}
+
+bool SeaLevelCalibrator::takeResult(float* seaLevelPa, float* knownAltitudeM) {
+    if (state != SEA_LEVEL_DONE) return false;
+    *seaLevelPa = result;
+    if (knownAltitudeM) *knownAltitudeM = altitudeM;
+    state = SEA_LEVEL_IDLE;
+    return true;
+}
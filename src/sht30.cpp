@@ -1,43 +1,98 @@
 #include "sht30.h"
 
+// Periodic mode commands by rate, then repeatability (high, medium, low)
+static const uint16_t periodicCommands[5][3] = {
+  { 0x2032, 0x2024, 0x202F },  // 0.5 mps
+  { 0x2130, 0x2126, 0x212D },  // 1 mps
+  { 0x2236, 0x2220, 0x222B },  // 2 mps
+  { 0x2334, 0x2322, 0x2329 },  // 4 mps
+  { 0x2737, 0x2721, 0x272A }   // 10 mps
+};
+
+// CRC-8, polynomial 0x31, init 0xFF (datasheet)
+static uint8_t crc8(const uint8_t* data, uint8_t len) {
+  uint8_t crc = 0xFF;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
 SHT30::SHT30() {
   _temperature = 0.0;
   _humidity = 0.0;
+  _periodic = false;
 }
 
 bool SHT30::begin(TwoWire *wire) {
-  _wire = wire;
-  
+  _dev.begin(wire, SHT30_ADDR);
+  _periodic = false;
+
   // Check if sensor responds
-  _wire->beginTransmission(0x44);
-  return (_wire->endTransmission() == 0);
+  if (!_dev.probe()) return false;
+
+  // It may still be in periodic mode from before an MCU reset. The result
+  // does not matter: a sensor already in single-shot mode may not ack the
+  // break, and the probe has shown it is there.
+  stopPeriodic();
+  return true;
 }
 
 bool SHT30::read() {
+  if (_periodic) return fetch();
+
   // Send measurement command
-  _wire->beginTransmission(0x44);
-  _wire->write(0x2C);
-  _wire->write(0x06);
-  if (_wire->endTransmission() != 0) return false;
-  
+  if (!_dev.writeCommand(SHT30_CMD_SINGLE_HIGH)) return false;
+
   delay(20); // Wait for measurement
-  
-  // Read 6 bytes
-  if (_wire->requestFrom(0x44, 6) != 6) return false;
-  
+
+  // Read 6 bytes: temperature, CRC, humidity, CRC
   uint8_t data[6];
-  for (int i = 0; i < 6; i++) {
-    data[i] = _wire->read();
+  if (!_dev.read(data, 6)) return false;
+  return decode(data);
+}
+
+bool SHT30::startPeriodic(SHT30Rate rate, SHT30Repeatability repeatability) {
+  // Switching rates needs a break first
+  if (_periodic && !stopPeriodic()) return false;
+
+  uint16_t command = SHT30_CMD_ART;
+  if (rate != SHT30_RATE_ART) {
+    command = periodicCommands[rate][repeatability];
   }
-  
+  if (!_dev.writeCommand(command)) return false;
+  _periodic = true;
+  return true;
+}
+
+bool SHT30::stopPeriodic() {
+  if (!_dev.writeCommand(SHT30_CMD_BREAK)) return false;
+  _periodic = false;
+  delay(1); // The sensor takes 1 ms to accept the next command
+  return true;
+}
+
+// Until a new measurement is ready the sensor NACKs the read
+bool SHT30::fetch() {
+  uint8_t data[6];
+  if (!_dev.readCommand(SHT30_CMD_FETCH, data, 6)) return false;
+  return decode(data);
+}
+
+bool SHT30::decode(const uint8_t* data) {
+  if (crc8(data, 2) != data[2] || crc8(data + 3, 2) != data[5]) return false;
+
   // Convert temperature
-  uint16_t temp_raw = (data[0] << 8) | data[1];
+  uint16_t temp_raw = be16(data);
   _temperature = -45.0 + 175.0 * (temp_raw / 65535.0);
-  
+
   // Convert humidity
-  uint16_t hum_raw = (data[3] << 8) | data[4];
+  uint16_t hum_raw = be16(data + 3);
   _humidity = 100.0 * (hum_raw / 65535.0);
-  
+
   return true;
 }
 
@@ -0,0 +1,146 @@
+#include "sparkline.h"
+#include <math.h>
+
+template <class Display>
+BasicSparkline<Display>::BasicSparkline(Display& display, int x, int page, uint8_t width, uint8_t pages)
+    : _display(display), _x(x), _page(page), _width(width), _pages(pages), replots(0) {
+    if (_width == 0) _width = 1;
+    if (_width > SPARKLINE_MAX_SAMPLES) _width = SPARKLINE_MAX_SAMPLES;
+    if (_pages == 0) _pages = 1;
+    seq = 0;
+    count = 0;
+    minHead = minLen = 0;
+    maxHead = maxLen = 0;
+    scaled = false;
+    scaleLo = scaleHi = 0.0f;
+}
+
+template <class Display>
+void BasicSparkline<Display>::clear() {
+    seq = 0;
+    count = 0;
+    minHead = minLen = 0;
+    maxHead = maxLen = 0;
+    scaled = false;
+    int y0 = _page * 8;
+    _display.fillArea(_x, y0, _x + _width - 1, y0 + _pages * 8 - 1, false);
+}
+
+template <class Display>
+float BasicSparkline<Display>::getMin() const {
+    return minLen ? sampleAt(minDeque[minHead]) : 0.0f;
+}
+
+template <class Display>
+float BasicSparkline<Display>::getMax() const {
+    return maxLen ? sampleAt(maxDeque[maxHead]) : 0.0f;
+}
+
+template <class Display>
+float BasicSparkline<Display>::getLatest() const {
+    return count ? sampleAt(seq - 1) : 0.0f;
+}
+
+template <class Display>
+void BasicSparkline<Display>::addSample(float value) {
+    uint32_t s = seq;
+    pushDeques(value);
+    seq++;
+    if (count < _width) count++;
+
+    if (updateScale()) {
+        replot();
+    } else {
+        _display.shiftPagesLeft(_x, _page, _width, _pages, 1);
+        drawColumn(_width - 1, s);
+    }
+}
+
+template <class Display>
+void BasicSparkline<Display>::pushDeques(float value) {
+    uint32_t s = seq;
+
+    // Drop the sample leaving the window; it can only be at a deque front
+    if (minLen && s - minDeque[minHead] >= _width) {
+        minHead = (minHead + 1) % _width;
+        minLen--;
+    }
+    if (maxLen && s - maxDeque[maxHead] >= _width) {
+        maxHead = (maxHead + 1) % _width;
+        maxLen--;
+    }
+
+    // Its ring slot is now free for the new sample
+    samples[s % _width] = value;
+
+    // Samples dominated by the new one can never be the window min/max again
+    while (minLen && sampleAt(minDeque[(minHead + minLen - 1) % _width]) >= value) minLen--;
+    minDeque[(minHead + minLen) % _width] = s;
+    minLen++;
+    while (maxLen && sampleAt(maxDeque[(maxHead + maxLen - 1) % _width]) <= value) maxLen--;
+    maxDeque[(maxHead + maxLen) % _width] = s;
+    maxLen++;
+}
+
+// Keeps the drawn scale while the window fits inside it with reasonable
+// resolution; otherwise picks a new padded range and asks for a re-plot
+template <class Display>
+bool BasicSparkline<Display>::updateScale() {
+    float lo = getMin();
+    float hi = getMax();
+    float pad = (hi - lo) * 0.1f;
+    if (pad <= 0.0f) pad = fmaxf(fabsf(hi) * 0.001f, 0.001f);
+    float targetLo = lo - pad;
+    float targetHi = hi + pad;
+
+    bool expand = !scaled || lo < scaleLo || hi > scaleHi;
+    bool shrink = scaled && (targetHi - targetLo) < 0.5f * (scaleHi - scaleLo);
+    if (!expand && !shrink) return false;
+
+    scaleLo = targetLo;
+    scaleHi = targetHi;
+    scaled = true;
+    return true;
+}
+
+template <class Display>
+int BasicSparkline<Display>::rowFor(float value) const {
+    int height = _pages * 8;
+    float t = (value - scaleLo) / (scaleHi - scaleLo);
+    int row = (height - 1) - (int)lroundf(t * (height - 1));
+    if (row < 0) row = 0;
+    if (row > height - 1) row = height - 1;
+    return _page * 8 + row;
+}
+
+// Draws sample s as a vertical segment joining it to the previous sample
+template <class Display>
+void BasicSparkline<Display>::drawColumn(int column, uint32_t s) {
+    int x = _x + column;
+    int top = _page * 8;
+    _display.fillArea(x, top, x, top + _pages * 8 - 1, false);
+
+    int y = rowFor(sampleAt(s));
+    int y0 = y, y1 = y;
+    if (s + count > seq) { // s - 1 is still inside the window
+        int prev = rowFor(sampleAt(s - 1));
+        y0 = min(y, prev);
+        y1 = max(y, prev);
+    }
+    _display.fillArea(x, y0, x, y1, true);
+}
+
+template <class Display>
+void BasicSparkline<Display>::replot() {
+    int top = _page * 8;
+    _display.fillArea(_x, top, _x + _width - 1, top + _pages * 8 - 1, false);
+    for (uint32_t s = seq - count; s != seq; s++) {
+        drawColumn(_width - 1 - (seq - 1 - s), s);
+    }
+    replots++;
+}
+
+// Display types available to host builds and OLED_BACKEND
+template class BasicSparkline<OLEDDisplay<SSD1306Backend>>;
+template class BasicSparkline<OLEDDisplay<SH1106Backend>>;
+template class BasicSparkline<OLEDDisplay<MemoryBackend>>;
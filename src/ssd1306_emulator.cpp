@@ -0,0 +1,177 @@
+#include "ssd1306_emulator.h"
+
+SSD1306Emulator::SSD1306Emulator() {
+    reset();
+}
+
+// Power-on defaults per the SSD1306 datasheet
+void SSD1306Emulator::reset() {
+    memset(ram, 0, sizeof(ram));
+    memoryMode = 2;
+    colStart = 0;
+    colEnd = SSD1306_EMU_WIDTH - 1;
+    col = 0;
+    pageStart = 0;
+    pageEnd = SSD1306_EMU_PAGES - 1;
+    page = 0;
+    startLine = 0;
+    displayOn = false;
+    inverted = false;
+    cmdLen = 0;
+    argsNeeded = 0;
+    resetCounters();
+}
+
+void SSD1306Emulator::resetCounters() {
+    transactions = 0;
+    commandBytes = 0;
+    dataBytes = 0;
+}
+
+void SSD1306Emulator::receive(const uint8_t* bytes, uint16_t count) {
+    transactions++;
+    uint16_t i = 0;
+    while (i < count) {
+        uint8_t control = bytes[i++];
+        bool isData = control & 0x40;
+        if (control & 0x80) {
+            // Co = 1: the control byte covers only the next byte
+            if (i < count) {
+                if (isData) data(bytes[i]);
+                else command(bytes[i]);
+                i++;
+            }
+        } else {
+            // Co = 0: everything up to the stop condition
+            for (; i < count; i++) {
+                if (isData) data(bytes[i]);
+                else command(bytes[i]);
+            }
+        }
+    }
+}
+
+void SSD1306Emulator::receive(uint8_t control, const uint8_t* payload, uint16_t count) {
+    transactions++;
+    bool isData = control & 0x40;
+    // With Co = 1 only the first payload byte is covered; the transport never
+    // sends that form with more than one byte, so treat both alike
+    for (uint16_t i = 0; i < count; i++) {
+        if (isData) data(payload[i]);
+        else command(payload[i]);
+    }
+}
+
+void SSD1306Emulator::command(uint8_t byte) {
+    commandBytes++;
+    if (argsNeeded > 0) {
+        cmd[cmdLen++] = byte;
+        if (--argsNeeded == 0) applyCommand();
+        return;
+    }
+
+    cmd[0] = byte;
+    cmdLen = 1;
+    switch (byte) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            argsNeeded = 1;
+            break;
+        case 0x21: case 0x22: case 0xA3:
+            argsNeeded = 2;
+            break;
+        case 0x29: case 0x2A:
+            argsNeeded = 5;
+            break;
+        case 0x26: case 0x27:
+            argsNeeded = 6;
+            break;
+        default:
+            applyCommand();
+            break;
+    }
+}
+
+void SSD1306Emulator::applyCommand() {
+    uint8_t op = cmd[0];
+    if (op == 0x20) {
+        memoryMode = cmd[1] & 0x03;
+    } else if (op == 0x21) {
+        colStart = cmd[1] & 0x7F;
+        colEnd = cmd[2] & 0x7F;
+        col = colStart;
+    } else if (op == 0x22) {
+        pageStart = cmd[1] & 0x07;
+        pageEnd = cmd[2] & 0x07;
+        page = pageStart;
+    } else if (op <= 0x0F) {
+        col = (col & 0xF0) | op;          // Page mode: lower column nibble
+    } else if (op >= 0x10 && op <= 0x1F) {
+        col = (col & 0x0F) | ((op & 0x07) << 4); // Page mode: upper column nibble
+    } else if (op >= 0x40 && op <= 0x7F) {
+        startLine = op & 0x3F;
+    } else if (op >= 0xB0 && op <= 0xB7) {
+        page = op & 0x07;                 // Page mode: page start
+    } else if (op == 0xA6 || op == 0xA7) {
+        inverted = (op == 0xA7);
+    } else if (op == 0xAE || op == 0xAF) {
+        displayOn = (op == 0xAF);
+    }
+    // Remaining commands (contrast, timing, scrolling, remap) don't change RAM
+}
+
+void SSD1306Emulator::data(uint8_t byte) {
+    dataBytes++;
+    ram[page][col] = byte;
+    switch (memoryMode) {
+        case 0: // Horizontal: across the column window, then next page
+            if (col >= colEnd) {
+                col = colStart;
+                page = (page >= pageEnd) ? pageStart : page + 1;
+            } else {
+                col++;
+            }
+            break;
+        case 1: // Vertical: down the page window, then next column
+            if (page >= pageEnd) {
+                page = pageStart;
+                col = (col >= colEnd) ? colStart : col + 1;
+            } else {
+                page++;
+            }
+            break;
+        default: // Page: column pointer only, wrapping within the page
+            col = (col + 1) & (SSD1306_EMU_WIDTH - 1);
+            break;
+    }
+}
+
+bool SSD1306Emulator::getPixel(int x, int y) const {
+    if (x < 0 || x >= SSD1306_EMU_WIDTH || y < 0 || y >= SSD1306_EMU_PAGES * 8) return false;
+    int row = (y + startLine) & (SSD1306_EMU_PAGES * 8 - 1);
+    bool lit = (ram[row >> 3][x] >> (row & 7)) & 1;
+    return lit != inverted;
+}
+
+void SSD1306Emulator::writePBM(Print& out) const {
+    out.print("P4\n128 64\n");
+    for (int y = 0; y < SSD1306_EMU_PAGES * 8; y++) {
+        for (int x = 0; x < SSD1306_EMU_WIDTH; x += 8) {
+            uint8_t packed = 0;
+            for (int b = 0; b < 8; b++) {
+                if (getPixel(x + b, y)) packed |= 0x80 >> b;
+            }
+            out.write(packed);
+        }
+    }
+}
+
+uint32_t SSD1306Emulator::frameHash() const {
+    uint32_t hash = 2166136261UL;
+    for (int y = 0; y < SSD1306_EMU_PAGES * 8; y++) {
+        for (int x = 0; x < SSD1306_EMU_WIDTH; x++) {
+            hash = (hash ^ (getPixel(x, y) ? 1 : 0)) * 16777619UL;
+        }
+    }
+    return hash;
+}
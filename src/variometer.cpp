@@ -0,0 +1,114 @@
+#include "variometer.h"
+#include <math.h>
+
+Variometer::Variometer(float alpha, float beta)
+    : alphaRateQ32(0), betaRateQ32(0), altitudeQ8(0), speedQ8(0), lastMs(0), samples(0),
+      intervalQ8(0), residualVarQ16(0), altitudeLagSamples(0), speedLagSamples(0),
+      residualGain(1), altitudeGain(1), speedGain(1) {
+    setGains(alpha, beta);
+}
+
+void Variometer::setGains(float alpha, float beta) {
+    alpha = constrain(alpha, 0.001f, 1.0f);
+    beta = constrain(beta, 0.0f, 1.0f);
+    alphaRateQ32 = (uint32_t)(alpha / VARIO_REFERENCE_MS * 4294967296.0 + 0.5);
+    betaRateQ32 = (uint32_t)(beta * 1000.0 / (VARIO_REFERENCE_MS * VARIO_REFERENCE_MS) *
+                             4294967296.0 + 0.5);
+
+    // Step responses at one sample per reference interval
+    const int limit = 10000;
+    float x = 0, v = 0;
+    int n = 0;
+    for (; n < limit && x < 0.63f; n++) {   // Altitude steps from 0 to 1
+        float r = 1.0f - (x + v);
+        x += v + alpha * r;
+        v += beta * r;
+    }
+    altitudeLagSamples = n;
+    x = 0;
+    v = 0;
+    for (n = 0; n < limit && v < 0.63f; n++) {  // Climb of 1 per sample starts
+        float predicted = x + v;
+        float r = (float)(n + 1) - predicted;
+        x = predicted + alpha * r;
+        v += beta * r;
+    }
+    speedLagSamples = n;
+
+    // Unit white noise in, variance of each output measured after settling
+    uint32_t seed = 12345;
+    double rr = 0, xx = 0, vv = 0;
+    const int settle = 2000, count = 8000;
+    x = 0;
+    v = 0;
+    for (n = 0; n < settle + count; n++) {
+        float noise = -6.0f;                 // Sum of 12 uniforms: mean 0, variance 1
+        for (int k = 0; k < 12; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            noise += (seed >> 8) / 16777216.0f;
+        }
+        float predicted = x + v;
+        float r = noise - predicted;
+        x = predicted + alpha * r;
+        v += beta * r;
+        if (n >= settle) {
+            rr += r * r;
+            xx += x * x;
+            vv += v * v;
+        }
+    }
+    residualGain = rr / count;
+    altitudeGain = xx / count;
+    speedGain = vv / count;
+}
+
+void Variometer::reset() {
+    samples = 0;
+    speedQ8 = 0;
+    residualVarQ16 = 0;
+}
+
+bool Variometer::update(int32_t altitudeCm, uint32_t nowMs) {
+    uint32_t dt = nowMs - lastMs;
+    if (samples > 0 && dt == 0) return false;
+    if (samples == 0 || dt > VARIO_MAX_GAP_MS) {
+        altitudeQ8 = (int64_t)altitudeCm << 8;
+        speedQ8 = 0;
+        lastMs = nowMs;
+        samples = 1;
+        return false;
+    }
+    lastMs = nowMs;
+
+    int64_t predicted = altitudeQ8 + speedQ8 * dt / 1000;
+    int64_t residual = ((int64_t)altitudeCm << 8) - predicted;
+    uint64_t alphaQ32 = (uint64_t)alphaRateQ32 * dt;
+    if (alphaQ32 > (1ULL << 32)) alphaQ32 = 1ULL << 32;
+    altitudeQ8 = predicted + ((residual * (int64_t)alphaQ32) >> 32);
+    // beta * k^2 / dt * 1000 = betaRate * dt
+    speedQ8 += (((residual * betaRateQ32) >> 16) * dt) >> 16;
+
+    // Running averages over about 16 and 64 samples
+    if (intervalQ8 == 0) intervalQ8 = dt << 8;
+    intervalQ8 += ((int32_t)(dt << 8) - (int32_t)intervalQ8) / 16;
+    int64_t squared = residual * residual;               // Q16 cm^2
+    residualVarQ16 += (squared - residualVarQ16) / 64;
+
+    samples++;
+    return true;
+}
+
+float Variometer::getSensorNoiseCm() const {
+    return sqrtf(residualVarQ16 / 65536.0f / residualGain);
+}
+
+// With the time constants fixed, output noise variance scales with the
+// sample interval: faster sampling averages more samples per time constant
+float Variometer::getAltitudeNoiseCm() const {
+    return getSensorNoiseCm() * sqrtf(altitudeGain * getSampleIntervalMs() / VARIO_REFERENCE_MS);
+}
+
+float Variometer::getSpeedNoiseCms() const {
+    return getSensorNoiseCm() * sqrtf(speedGain * getSampleIntervalMs() / VARIO_REFERENCE_MS) /
+           (VARIO_REFERENCE_MS / 1000.0f);
+}
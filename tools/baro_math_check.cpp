@@ -0,0 +1,126 @@
+// Host accuracy check and benchmark for baro_math against the powf formula,
+// and a simulated flight through the variometer and the OSS policy.
+//
+//   g++ -O2 -std=c++11 -Itools/host -Iinclude tools/baro_math_check.cpp src/baro_math.cpp
+//       src/variometer.cpp src/bmp180_oss_policy.cpp src/bmp180.cpp src/i2c_device.cpp
+//       tools/host/host.cpp -o baro_math_check
+//
+// Sweeps -500 m to 9000 m in 1 cm steps (p0 = 101325 Pa) and exits non-zero
+// if any result is outside the bounds documented in baro_math.h, or if the
+// policy does not settle back to its stationary settings after a climb.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "baro_math.h"
+#include "variometer.h"
+#include "bmp180_oss_policy.h"
+
+static const float P0 = 101325.0f;
+static volatile float sink;
+
+static float powfAltitude(float p, float p0) {
+    return 44330.0f * (1.0f - powf(p / p0, 0.190294957f));
+}
+
+static float powfSeaLevel(float p, float h) {
+    return p / powf(1.0f - h / 44330.0f, 5.255f);
+}
+
+template <class F>
+static double nsPerCall(const std::vector<float>& input, F f) {
+    auto start = std::chrono::steady_clock::now();
+    float acc = 0.0f;
+    for (int round = 0; round < 20; round++) {
+        for (size_t i = 0; i < input.size(); i++) acc += f(input[i]);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (20.0 * input.size());
+}
+
+// 20 s still, a 20 s climb at 2 m/s, then 60 s still. Each sample takes the
+// time and has the noise the policy chose, as in main.cpp's streaming loop.
+// The climb must switch to the moving settings, and the noisier fast samples
+// must not keep the policy there once the climb is over.
+static bool stationaryTrace() {
+    Variometer vario;
+    BMP180OssPolicy policy(100.0f, 2.0f);
+    std::mt19937 rng(1);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    BMP180OssChoice choice = policy.getChoice();
+    double t = 0;
+    float h = 0;
+    bool climbSeen = false;
+    double settledMs = -1;
+    uint32_t lateMoving = 0, lateSamples = 0;
+    while (t < 100000) {
+        t += choice.timeMs;
+        if (t > 20000 && t <= 40000) h += 2.0f * choice.timeMs / 1000.0f;
+        float p = 101325.0f * powf(1.0f - h / 44330.0f, 5.255f) + gauss(rng) * choice.noisePa;
+        vario.update(baroAltitudeCm((int32_t)lroundf(p), 101325), (uint32_t)t);
+        choice = policy.choose(vario.getSpeed(), (uint32_t)t);
+        if (t > 20000 && t <= 40000 && choice.moving) climbSeen = true;
+        if (t > 40000 && settledMs < 0 && !choice.moving) settledMs = t - 40000;
+        if (t > 70000) {
+            lateSamples++;
+            if (choice.moving || choice.oss != BMP180_OSS_ULTRAHIGHRES) lateMoving++;
+        }
+    }
+    printf("policy trace: climb %s, still again %.1f s after it, %u/%u moving samples in the last 30 s\n",
+           climbSeen ? "seen" : "missed", settledMs / 1000.0, lateMoving, lateSamples);
+    return climbSeen && settledMs >= 0 && settledMs <= 20000 && lateMoving == 0;
+}
+
+int main() {
+    double worstAlt = 0, worstAltPowf = 0, worstSea = 0, worstSeaPowf = 0, worstCm = 0, worstBatch = 0;
+    std::vector<float> pressures;
+    for (int cm = -50000; cm <= 900000; cm++) {
+        double h = cm / 100.0;
+        double pExact = 101325.0 * pow(1.0 - h / 44330.0, 5.255);
+        float p = (float)pExact;
+        pressures.push_back(p);
+
+        // Reference altitude for the float input actually passed in
+        double ref = 44330.0 * (1.0 - pow((double)p / P0, 0.190294957));
+        worstAlt = std::max(worstAlt, fabs(baroAltitudeFast(p, P0) - ref));
+        worstAltPowf = std::max(worstAltPowf, fabs(powfAltitude(p, P0) - ref));
+        worstCm = std::max(worstCm, fabs(baroAltitudeCm((int32_t)lround(p), (int32_t)P0) / 100.0 -
+                                         44330.0 * (1.0 - pow(lround(p) / 101325.0, 0.190294957))));
+
+        double seaRef = (double)p / pow(1.0 - (float)h / 44330.0, 5.255);
+        worstSea = std::max(worstSea, fabs(baroSeaLevelFast(p, (float)h) - seaRef));
+        worstSeaPowf = std::max(worstSeaPowf, fabs(powfSeaLevel(p, (float)h) - seaRef));
+    }
+
+    std::vector<float> altitudes(pressures.size());
+    baroAltitudeBatch(pressures.data(), altitudes.data(), (uint16_t)4096, P0);
+    for (size_t i = 0; i < 4096; i++) {
+        worstBatch = std::max(worstBatch, fabs((double)altitudes[i] - baroAltitude(pressures[i], P0)));
+    }
+
+    printf("max error vs double reference, -500..9000 m:\n");
+    printf("  powf altitude       %.4f m\n", worstAltPowf);
+    printf("  baroAltitudeFast    %.4f m\n", worstAlt);
+    printf("  baroAltitudeBatch   %.4f m (vs baroAltitude)\n", worstBatch);
+    printf("  baroAltitudeCm      %.4f m\n", worstCm);
+    printf("  powf sea level      %.4f Pa\n", worstSeaPowf);
+    printf("  baroSeaLevelFast    %.4f Pa\n", worstSea);
+
+    double tPowf = nsPerCall(pressures, [](float p) { return powfAltitude(p, P0); });
+    double tFast = nsPerCall(pressures, [](float p) { return baroAltitudeFast(p, P0); });
+    double tCm = nsPerCall(pressures, [](float p) { return (float)baroAltitudeCm((int32_t)p, 101325); });
+    double tSeaPowf = nsPerCall(pressures, [](float p) { return powfSeaLevel(101325.0f, p * 0.01f); });
+    double tSea = nsPerCall(pressures, [](float p) { return baroSeaLevelFast(101325.0f, p * 0.01f); });
+    // Host libm timings say little about the ESP32's newlib powf, which is
+    // why the fast path is opt-in (-DBARO_MATH_FAST)
+    printf("altitude  powf %6.1f ns  fast %6.1f ns  fixed %6.1f ns\n", tPowf, tFast, tCm);
+    printf("sea level powf %6.1f ns  fast %6.1f ns\n", tSeaPowf, tSea);
+
+    bool ok = worstAlt <= 0.01 && worstBatch <= 0.01 && worstCm <= 0.01 && worstSea <= 0.1;
+    ok = stationaryTrace() && ok;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Just enough of the Arduino core to build the display and sensor code on a
+// desktop for the programs in tools/. Time is real time since start-up.
+// Build with -Itools/host and link tools/host/host.cpp.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+
+#define F(s) (s)
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+
+template <class T, class L, class H>
+T constrain(T x, L low, H high) { return x < low ? (T)low : (x > high ? (T)high : x); }
+
+class String {
+public:
+    String(const char* s = "") : _s(s) {}
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+
+private:
+    std::string _s;
+};
+
+// Byte sink with the bits of the Arduino Print API the tree uses
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        for (size_t i = 0; i < size; i++) write(buffer[i]);
+        return size;
+    }
+    virtual int availableForWrite() { return 0; }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+};
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,42 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+// A bus with nothing on it: every transfer is NACKed. Host programs drive
+// the display through the SSD1306 emulator instead, or attach() a device
+// model, which then sees each write transaction and ACKs it.
+class TwoWire {
+public:
+    typedef void (*Device)(uint8_t address, const uint8_t* bytes, size_t count, void* context);
+
+    TwoWire(uint8_t = 0) : device(nullptr), context(nullptr), address(0), length(0) {}
+    void attach(Device model, void* modelContext) { device = model; context = modelContext; }
+    bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+    bool setClock(uint32_t) { return true; }
+    void beginTransmission(uint8_t to) { address = to; length = 0; }
+    uint8_t endTransmission(bool = true) {
+        if (device == nullptr) return 2;
+        device(address, buffer, length, context);
+        return 0;
+    }
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t* bytes, size_t size) {
+        for (size_t i = 0; i < size && length < sizeof(buffer); i++) buffer[length++] = bytes[i];
+        return size;
+    }
+    uint8_t requestFrom(uint8_t, uint8_t, bool = true) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+
+private:
+    Device device;
+    void* context;
+    uint8_t address;
+    uint8_t buffer[256];
+    size_t length;
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
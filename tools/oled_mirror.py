@@ -0,0 +1,185 @@
+"""Viewer for OLED frames mirrored over the serial port (see screen_mirror.h).
+
+Reads packets from a serial port (needs pyserial) or from a capture file,
+rebuilds each frame and draws it in the terminal, or writes one PBM per
+frame. Ordinary log text on the same port is passed through to stderr.
+
+    python3 tools/oled_mirror.py /dev/ttyUSB0
+    python3 tools/oled_mirror.py capture.bin --pbm frames/
+"""
+
+import argparse
+import os
+import sys
+
+WIDTH = 128
+HEIGHT = 64
+FRAME_SIZE = WIDTH * HEIGHT // 8
+SYNC = b"\xA5\x5A"
+HEADER_SIZE = 7
+KEYFRAME = ord("K")
+DELTA = ord("D")
+
+
+def rle_decode(payload):
+    out = bytearray()
+    i = 0
+    while i < len(payload):
+        control = payload[i]
+        i += 1
+        if control < 0x80:
+            out += payload[i:i + control + 1]
+            i += control + 1
+        else:
+            out += bytes([payload[i]]) * ((control & 0x7F) + 3)
+            i += 1
+    return out
+
+
+class Decoder:
+    def __init__(self):
+        self.buffer = bytearray()
+        self.frame = None          # Panel RAM, page-major like the firmware
+        self.expected_seq = None
+        self.frames = 0
+        self.errors = 0
+
+    def feed(self, data):
+        """Yields (frame, start_line) for each complete frame and
+        bytes of non-packet text in between."""
+        self.buffer += data
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                # Keep a trailing 0xA5 that may begin the next sync
+                keep = 1 if self.buffer.endswith(SYNC[:1]) else 0
+                text = bytes(self.buffer[:len(self.buffer) - keep])
+                del self.buffer[:len(self.buffer) - keep]
+                if text:
+                    yield text
+                return
+            if start > 0:
+                yield bytes(self.buffer[:start])
+                del self.buffer[:start]
+            if len(self.buffer) < HEADER_SIZE:
+                return
+            kind, seq, start_line = self.buffer[2], self.buffer[3], self.buffer[4]
+            length = self.buffer[5] | (self.buffer[6] << 8)
+            total = HEADER_SIZE + length + 1
+            if kind not in (KEYFRAME, DELTA) or length > 2 * FRAME_SIZE:
+                del self.buffer[:1]
+                continue
+            if len(self.buffer) < total:
+                return
+            packet = self.buffer[:total]
+            if sum(packet[2:total - 1]) & 0xFF != packet[total - 1]:
+                self.errors += 1
+                del self.buffer[:1]
+                continue
+            del self.buffer[:total]
+            if self.apply(kind, seq, packet[HEADER_SIZE:total - 1]):
+                yield (bytes(self.frame), start_line)
+
+    def apply(self, kind, seq, payload):
+        if kind == KEYFRAME:
+            data = rle_decode(payload)
+            if len(data) != FRAME_SIZE:
+                self.errors += 1
+                return False
+            self.frame = data
+        else:
+            # A delta only applies on top of the packet right before it
+            if self.frame is None or seq != self.expected_seq:
+                self.frame = None
+                return False
+            if payload:
+                delta = rle_decode(payload)
+                if len(delta) != FRAME_SIZE:
+                    self.errors += 1
+                    self.frame = None
+                    return False
+                for i, d in enumerate(delta):
+                    self.frame[i] ^= d
+        self.expected_seq = (seq + 1) & 0xFF
+        self.frames += 1
+        return True
+
+
+def visible_pixel(frame, start_line, x, y):
+    row = (y + start_line) % HEIGHT
+    return (frame[x + (row // 8) * WIDTH] >> (row & 7)) & 1
+
+
+def render_terminal(frame, start_line):
+    # Two pixel rows per character cell
+    glyphs = {(0, 0): " ", (1, 0): "▀", (0, 1): "▄", (1, 1): "█"}
+    lines = []
+    for y in range(0, HEIGHT, 2):
+        lines.append("".join(glyphs[(visible_pixel(frame, start_line, x, y),
+                                     visible_pixel(frame, start_line, x, y + 1))]
+                             for x in range(WIDTH)))
+    sys.stdout.write("\x1b[H" + "\n".join(lines) + "\n")
+    sys.stdout.flush()
+
+
+def write_pbm(path, frame, start_line):
+    with open(path, "wb") as f:
+        f.write(b"P4\n%d %d\n" % (WIDTH, HEIGHT))
+        for y in range(HEIGHT):
+            row = bytearray(WIDTH // 8)
+            for x in range(WIDTH):
+                if visible_pixel(frame, start_line, x, y):
+                    row[x // 8] |= 0x80 >> (x & 7)
+            f.write(row)
+
+
+def open_source(path, baud):
+    if os.path.exists(path) and not path.startswith("/dev/"):
+        return open(path, "rb")
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial is needed to read a serial port (pip install pyserial)")
+    return serial.Serial(path, baud, timeout=0.1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="serial port or capture file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--pbm", metavar="DIR", help="write each frame as DIR/frame_NNNNN.pbm")
+    parser.add_argument("--quiet-log", action="store_true", help="drop non-frame text")
+    args = parser.parse_args()
+
+    source = open_source(args.source, args.baud)
+    is_file = not hasattr(source, "baudrate")
+    decoder = Decoder()
+    if args.pbm:
+        os.makedirs(args.pbm, exist_ok=True)
+    else:
+        sys.stdout.write("\x1b[2J")
+
+    try:
+        while True:
+            data = source.read(4096)
+            if not data:
+                if is_file:
+                    break
+                continue
+            for item in decoder.feed(data):
+                if isinstance(item, bytes):
+                    if not args.quiet_log:
+                        sys.stderr.write(item.decode("utf-8", "replace"))
+                    continue
+                frame, start_line = item
+                if args.pbm:
+                    write_pbm(os.path.join(args.pbm, "frame_%05d.pbm" % decoder.frames), frame, start_line)
+                else:
+                    render_terminal(frame, start_line)
+    except KeyboardInterrupt:
+        pass
+    sys.stderr.write("\n%d frames, %d bad packets\n" % (decoder.frames, decoder.errors))
+
+
+if __name__ == "__main__":
+    main()